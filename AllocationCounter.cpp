@@ -0,0 +1,77 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<long long> g_NumOfAllocations{ 0 };
+	std::atomic<long long> g_NumOfBytes{ 0 };
+
+	void* CountedAllocate(std::size_t size)
+	{
+		g_NumOfAllocations.fetch_add(1, std::memory_order_relaxed);
+		g_NumOfBytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+
+		//malloc(0) is allowed to return nullptr, new is not
+		return std::malloc(size > 0 ? size : 1);
+	}
+}
+
+utils::AllocationStats utils::GetAllocationStats()
+{
+	return AllocationStats{ g_NumOfAllocations.load(std::memory_order_relaxed), g_NumOfBytes.load(std::memory_order_relaxed) };
+}
+
+void* operator new(std::size_t size)
+{
+	void* pMemory{ CountedAllocate(size) };
+	if (pMemory == nullptr) throw std::bad_alloc{};
+	return pMemory;
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return CountedAllocate(size);
+}
+
+void operator delete(void* pMemory) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete[](void* pMemory) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete(void* pMemory, std::size_t) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete[](void* pMemory, std::size_t) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete(void* pMemory, const std::nothrow_t&) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete[](void* pMemory, const std::nothrow_t&) noexcept
+{
+	std::free(pMemory);
+}
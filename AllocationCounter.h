@@ -0,0 +1,14 @@
+#pragma once
+
+//Counts every heap allocation made through operator new.
+//Only programs that link AllocationCounter.cpp replace the global allocator, everything else reports zero.
+namespace utils
+{
+	struct AllocationStats
+	{
+		long long numOfAllocations;
+		long long numOfBytes;
+	};
+
+	AllocationStats GetAllocationStats();
+}
@@ -0,0 +1,256 @@
+//Command line tool that generates a range of seeds on every core and writes the dungeons to a file
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "DungeonGenerator.h"
+#include "ThreadPool.h"
+
+struct BatchSettings
+{
+	unsigned int seedStart{ 0 };
+	unsigned int seedEnd{ 1000 }; //Exclusive
+	int minimumNumOfRooms{ 10 };
+	float roomTightness{ 1.f };
+	int numOfThreads{ 0 };
+	int seedsPerTask{ 16 };
+	std::string outputPath{ "dungeons.txt" };
+};
+
+void PrintUsage()
+{
+	std::cout << "Usage: DungeonBatch [options]\n"
+		<< "  --seed-start <n>   First seed to generate (default 0)\n"
+		<< "  --seed-end <n>     Seed to stop at, exclusive (default 1000)\n"
+		<< "  --rooms <n>        Minimum number of rooms per dungeon (default 10)\n"
+		<< "  --tightness <f>    Room tightness in [1,3] (default 1)\n"
+		<< "  --threads <n>      Worker threads, 0 uses every core (default 0)\n"
+		<< "  --output <path>    File to write the dungeons to, \"-\" to skip writing (default dungeons.txt)\n";
+}
+
+bool ParseArguments(int argc, char* argv[], BatchSettings& settings)
+{
+	for (int i{ 1 }; i < argc; ++i)
+	{
+		const std::string argument{ argv[i] };
+		if (argument == "--help" || argument == "-h") return false;
+		if (i + 1 >= argc)
+		{
+			std::cerr << "Missing value for " << argument << std::endl;
+			return false;
+		}
+
+		const char* value{ argv[++i] };
+		if (argument == "--seed-start") settings.seedStart = unsigned(std::strtoul(value, nullptr, 10));
+		else if (argument == "--seed-end") settings.seedEnd = unsigned(std::strtoul(value, nullptr, 10));
+		else if (argument == "--rooms") settings.minimumNumOfRooms = std::atoi(value);
+		else if (argument == "--tightness") settings.roomTightness = float(std::atof(value));
+		else if (argument == "--threads") settings.numOfThreads = std::atoi(value);
+		else if (argument == "--output") settings.outputPath = value;
+		else
+		{
+			std::cerr << "Unknown option " << argument << std::endl;
+			return false;
+		}
+	}
+
+	if (settings.seedEnd <= settings.seedStart || settings.minimumNumOfRooms < 3)
+	{
+		std::cerr << "Need a non-empty seed range and at least 3 rooms" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+DungeonParams CreateDungeonParams(const BatchSettings& settings, unsigned int seed)
+{
+	DungeonParams params{};
+	params.minimumNumOfRooms = settings.minimumNumOfRooms;
+	params.roomTightness = settings.roomTightness;
+	params.seed = seed;
+	params.ScaleSpawnArea();
+
+	return params;
+}
+
+std::string SerializeDungeon(unsigned int seed, const DungeonResult& dungeon)
+{
+	std::ostringstream stream{};
+	stream << std::fixed << std::setprecision(2);
+	stream << "dungeon " << seed << " rooms " << dungeon.rooms.GetNumOfAliveRooms() << " hallways " << dungeon.hallways.size() << '\n';
+
+	const RoomStore& rooms{ dungeon.rooms };
+	for (int roomIdx{}; roomIdx < rooms.GetSize(); ++roomIdx)
+	{
+		if (!rooms.IsAlive(roomIdx)) continue;
+
+		const Rectf rect{ rooms.GetRect(roomIdx) };
+		stream << "room " << rooms.GetId(roomIdx) << ' ' << rect.left << ' ' << rect.bottom << ' '
+			<< rect.width << ' ' << rect.height << ' ' << int(rooms.GetType(roomIdx)) << '\n';
+	}
+	for (const auto& hallway : dungeon.hallways)
+	{
+		stream << "hallway " << hallway.startingPoint.x << ' ' << hallway.startingPoint.y << ' '
+			<< hallway.endPoint.x << ' ' << hallway.endPoint.y << '\n';
+	}
+
+	return stream.str();
+}
+
+//FNV-1a over the bytes of a value
+template<typename T>
+void HashValue(uint64_t& hash, const T& value)
+{
+	unsigned char bytes[sizeof(T)]{};
+	std::memcpy(bytes, &value, sizeof(T));
+	for (const unsigned char byte : bytes)
+	{
+		hash ^= byte;
+		hash *= 1099511628211ull;
+	}
+}
+
+//Changes when any room or hallway changes, even by one bit
+uint64_t HashDungeon(const DungeonResult& dungeon)
+{
+	uint64_t hash{ 14695981039346656037ull };
+	const RoomStore& rooms{ dungeon.rooms };
+	for (int roomIdx{}; roomIdx < rooms.GetSize(); ++roomIdx)
+	{
+		if (!rooms.IsAlive(roomIdx)) continue;
+
+		const Rectf rect{ rooms.GetRect(roomIdx) };
+		HashValue(hash, rooms.GetId(roomIdx));
+		HashValue(hash, rect.left);
+		HashValue(hash, rect.bottom);
+		HashValue(hash, rect.width);
+		HashValue(hash, rect.height);
+		HashValue(hash, int(rooms.GetType(roomIdx)));
+	}
+	for (const auto& hallway : dungeon.hallways)
+	{
+		HashValue(hash, hallway.startingPoint.x);
+		HashValue(hash, hallway.startingPoint.y);
+		HashValue(hash, hallway.endPoint.x);
+		HashValue(hash, hallway.endPoint.y);
+	}
+	return hash;
+}
+
+int main(int argc, char* argv[])
+{
+	BatchSettings settings{};
+	if (!ParseArguments(argc, argv, settings))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	const bool doWriteOutput{ settings.outputPath != "-" };
+	const unsigned int numOfDungeons{ settings.seedEnd - settings.seedStart };
+	std::vector<std::string> outputs(doWriteOutput ? numOfDungeons : 0);
+	std::vector<uint64_t> checksums(numOfDungeons);
+
+	std::mutex statsMutex{};
+	double stageSeconds[DungeonGenerator::done]{};
+	std::atomic<long long> numOfRooms{ 0 };
+	std::atomic<long long> numOfSeparationIterations{ 0 };
+	std::atomic<int> numOfUnseparated{ 0 };
+
+	const auto startTime{ std::chrono::steady_clock::now() };
+	{
+		ThreadPool threadPool{ settings.numOfThreads };
+		std::cout << "Generating " << numOfDungeons << " dungeons on " << threadPool.GetNumOfThreads() << " threads" << std::endl;
+
+		//Every task reuses one generator for a block of seeds. The size of a block comes from what is left,
+		//so a seed end close to UINT_MAX does not wrap around
+		unsigned int blockEnd{};
+		for (unsigned int blockStart{ settings.seedStart }; blockStart < settings.seedEnd; blockStart = blockEnd)
+		{
+			blockEnd = blockStart + std::min(settings.seedEnd - blockStart, unsigned(settings.seedsPerTask));
+			threadPool.Enqueue([&, blockStart, blockEnd]()
+				{
+					DungeonGenerator generator{};
+					double blockStageSeconds[DungeonGenerator::done]{};
+					long long blockNumOfRooms{};
+					long long blockNumOfIterations{};
+					int blockNumOfUnseparated{};
+
+					for (unsigned int seed{ blockStart }; seed < blockEnd; ++seed)
+					{
+						generator.Reset(CreateDungeonParams(settings, seed));
+						const DungeonResult& dungeon{ generator.Generate() };
+
+						for (int stage{}; stage < DungeonGenerator::done; ++stage)
+							blockStageSeconds[stage] += generator.GetStageSeconds(DungeonGenerator::Stage(stage));
+						blockNumOfRooms += static_cast<long long>(dungeon.rooms.GetNumOfAliveRooms());
+						blockNumOfIterations += dungeon.separationIterations;
+						if (!dungeon.isSeparated) ++blockNumOfUnseparated;
+
+						checksums[seed - settings.seedStart] = HashDungeon(dungeon);
+						if (doWriteOutput)
+							outputs[seed - settings.seedStart] = SerializeDungeon(seed, dungeon);
+					}
+
+					numOfRooms += blockNumOfRooms;
+					numOfSeparationIterations += blockNumOfIterations;
+					numOfUnseparated += blockNumOfUnseparated;
+					std::lock_guard<std::mutex> lock{ statsMutex };
+					for (int stage{}; stage < DungeonGenerator::done; ++stage)
+						stageSeconds[stage] += blockStageSeconds[stage];
+				});
+		}
+
+		threadPool.Wait();
+	}
+	const double wallSeconds{ std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() };
+
+	if (doWriteOutput)
+	{
+		std::ofstream file{ settings.outputPath };
+		if (!file)
+		{
+			std::cerr << "Could not open " << settings.outputPath << " for writing" << std::endl;
+			return 1;
+		}
+		for (const auto& output : outputs)
+			file << output;
+		std::cout << "Wrote " << numOfDungeons << " dungeons to " << settings.outputPath << std::endl;
+	}
+
+	//Combined in seed order, so the same seeds give the same checksum on any number of threads
+	uint64_t checksum{ 14695981039346656037ull };
+	for (const uint64_t dungeonChecksum : checksums)
+		HashValue(checksum, dungeonChecksum);
+
+	//Summary
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "Wall time:      " << wallSeconds << " s\n";
+	std::cout << "Dungeons/sec:   " << numOfDungeons / wallSeconds << '\n';
+	std::cout << "Checksum:       " << std::hex << std::setw(16) << std::setfill('0') << checksum << std::dec << std::setfill(' ') << '\n';
+	std::cout << "Average rooms:  " << double(numOfRooms) / numOfDungeons << '\n';
+	std::cout << "Separation:     " << double(numOfSeparationIterations) / numOfDungeons << " iterations on average, "
+		<< numOfUnseparated << " dungeon(s) still had overlapping rooms\n";
+	std::cout << "Average time per stage (ms per dungeon, single thread):\n";
+
+	double totalSeconds{};
+	for (int stage{}; stage < DungeonGenerator::done; ++stage)
+	{
+		totalSeconds += stageSeconds[stage];
+		std::cout << "  " << std::left << std::setw(24) << DungeonGenerator::GetStageName(DungeonGenerator::Stage(stage))
+			<< std::right << std::setw(10) << stageSeconds[stage] * 1000.0 / numOfDungeons << '\n';
+	}
+	std::cout << "  " << std::left << std::setw(24) << "Total" << std::right << std::setw(10) << totalSeconds * 1000.0 / numOfDungeons << std::endl;
+
+	return 0;
+}
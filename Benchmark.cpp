@@ -0,0 +1,401 @@
+//Benchmarks every stage of the generation pipeline for a range of room counts, and the whole pipeline once it is warmed up.
+//The triangulation is also run with and without the Hilbert insert order on the same points, to show what the order gains.
+//Results can be saved and compared against later runs to catch regressions.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "DungeonGenerator.h"
+
+struct BenchmarkSettings
+{
+	std::vector<int> roomCounts{ 10, 100, 1000, 10000, 100000 };
+	int maxRooms{ 1000 };
+	std::vector<unsigned int> seeds{ 1, 2, 3 };
+	double minSeconds{ 0.2 }; //Minimum measured time per benchmark
+	double maxWallSeconds{ 5.0 }; //Stops early when running the stages before the measured one gets too slow
+	int maxIterations{ 1000 };
+	int triangulationThreads{ 1 };
+	std::string filter{};
+	std::string savePath{};
+	std::string comparePath{};
+	double regressionPercentage{ 10.0 };
+};
+
+struct BenchmarkResult
+{
+	std::string name{};
+	int iterations{};
+	double nanoseconds{};
+	double allocations{};
+	double bytes{};
+};
+
+void PrintUsage()
+{
+	std::cout << "Usage: DungeonBenchmark [options]\n"
+		<< "  --max-rooms <n>      Skip room counts above this (default 1000, the largest is 100000)\n"
+		<< "  --min-time <s>       Minimum measured seconds per benchmark (default 0.2)\n"
+		<< "  --max-iterations <n> Maximum iterations per benchmark (default 1000)\n"
+		<< "  --max-wall-time <s>  Stop adding iterations after this many seconds, setup included (default 5)\n"
+		<< "  --triangulation-threads <n> Threads for the parallel triangulation, 1 uses the incremental one (default 1)\n"
+		<< "  --filter <text>      Only run benchmarks with this text in their name\n"
+		<< "  --save <path>        Save the results as a baseline\n"
+		<< "  --compare <path>     Compare the results against a saved baseline\n"
+		<< "  --threshold <pct>    Slowdown that counts as a regression (default 10)\n";
+}
+
+bool ParseArguments(int argc, char* argv[], BenchmarkSettings& settings)
+{
+	for (int i{ 1 }; i < argc; ++i)
+	{
+		const std::string argument{ argv[i] };
+		if (argument == "--help" || argument == "-h") return false;
+		if (i + 1 >= argc)
+		{
+			std::cerr << "Missing value for " << argument << std::endl;
+			return false;
+		}
+
+		const char* value{ argv[++i] };
+		if (argument == "--max-rooms") settings.maxRooms = std::atoi(value);
+		else if (argument == "--min-time") settings.minSeconds = std::atof(value);
+		else if (argument == "--max-iterations") settings.maxIterations = std::max(1, std::atoi(value));
+		else if (argument == "--max-wall-time") settings.maxWallSeconds = std::atof(value);
+		else if (argument == "--triangulation-threads") settings.triangulationThreads = std::max(1, std::atoi(value));
+		else if (argument == "--filter") settings.filter = value;
+		else if (argument == "--save") settings.savePath = value;
+		else if (argument == "--compare") settings.comparePath = value;
+		else if (argument == "--threshold") settings.regressionPercentage = std::atof(value);
+		else
+		{
+			std::cerr << "Unknown option " << argument << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+std::string CreateBenchmarkName(DungeonGenerator::Stage stage, int numOfRooms)
+{
+	std::string name{ DungeonGenerator::GetStageName(stage) };
+	std::replace(name.begin(), name.end(), ' ', '_');
+	return name + "/" + std::to_string(numOfRooms);
+}
+
+std::string CreatePipelineBenchmarkName(int numOfRooms)
+{
+	return "Full_Pipeline/" + std::to_string(numOfRooms);
+}
+
+std::string CreateInsertOrderBenchmarkName(bool isHilbertOrdered, int numOfRooms)
+{
+	return std::string{ isHilbertOrdered ? "Insert_Order_Hilbert/" : "Insert_Order_Index/" } + std::to_string(numOfRooms);
+}
+
+//Runs the pipeline up to the stage untimed, then measures only the stage itself
+BenchmarkResult RunStageBenchmark(DungeonGenerator& generator, DungeonGenerator::Stage stage, int numOfRooms, const BenchmarkSettings& settings)
+{
+	BenchmarkResult result{};
+	result.name = CreateBenchmarkName(stage, numOfRooms);
+
+	double totalSeconds{};
+	long long totalAllocations{}, totalBytes{};
+	const auto benchmarkStartTime{ std::chrono::steady_clock::now() };
+
+	while (result.iterations == 0 || (result.iterations < settings.maxIterations && totalSeconds < settings.minSeconds
+		&& std::chrono::duration<double>(std::chrono::steady_clock::now() - benchmarkStartTime).count() < settings.maxWallSeconds))
+	{
+		DungeonParams params{};
+		params.minimumNumOfRooms = numOfRooms;
+		params.seed = settings.seeds[result.iterations % settings.seeds.size()];
+		params.triangulationThreads = settings.triangulationThreads;
+		params.ScaleSpawnArea();
+
+		generator.Reset(params);
+		while (generator.GetStage() != stage)
+			generator.Step();
+
+		const utils::AllocationStats allocationsBefore{ utils::GetAllocationStats() };
+		const auto startTime{ std::chrono::steady_clock::now() };
+
+		while (generator.GetStage() == stage)
+			generator.Step();
+
+		totalSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		const utils::AllocationStats allocationsAfter{ utils::GetAllocationStats() };
+		totalAllocations += allocationsAfter.numOfAllocations - allocationsBefore.numOfAllocations;
+		totalBytes += allocationsAfter.numOfBytes - allocationsBefore.numOfBytes;
+
+		++result.iterations;
+	}
+
+	result.nanoseconds = totalSeconds * 1e9 / result.iterations;
+	result.allocations = double(totalAllocations) / result.iterations;
+	result.bytes = double(totalBytes) / result.iterations;
+	return result;
+}
+
+//Generates every seed once untimed so the generator has all of the memory it needs, then measures whole dungeons.
+//A generator that reuses its memory reports zero allocations here.
+BenchmarkResult RunPipelineBenchmark(DungeonGenerator& generator, int numOfRooms, const BenchmarkSettings& settings)
+{
+	BenchmarkResult result{};
+	result.name = CreatePipelineBenchmarkName(numOfRooms);
+
+	std::vector<DungeonParams> seedParams{};
+	for (const unsigned int seed : settings.seeds)
+	{
+		DungeonParams params{};
+		params.minimumNumOfRooms = numOfRooms;
+		params.seed = seed;
+		params.triangulationThreads = settings.triangulationThreads;
+		params.ScaleSpawnArea();
+		seedParams.emplace_back(params);
+	}
+
+	const auto benchmarkStartTime{ std::chrono::steady_clock::now() };
+	for (const auto& params : seedParams)
+	{
+		generator.Reset(params);
+		generator.Generate();
+	}
+
+	double totalSeconds{};
+	long long totalAllocations{}, totalBytes{};
+
+	while (result.iterations == 0 || (result.iterations < settings.maxIterations && totalSeconds < settings.minSeconds
+		&& std::chrono::duration<double>(std::chrono::steady_clock::now() - benchmarkStartTime).count() < settings.maxWallSeconds))
+	{
+		const DungeonParams& params{ seedParams[result.iterations % seedParams.size()] };
+
+		const utils::AllocationStats allocationsBefore{ utils::GetAllocationStats() };
+		const auto startTime{ std::chrono::steady_clock::now() };
+
+		generator.Reset(params);
+		generator.Generate();
+
+		totalSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		const utils::AllocationStats allocationsAfter{ utils::GetAllocationStats() };
+		totalAllocations += allocationsAfter.numOfAllocations - allocationsBefore.numOfAllocations;
+		totalBytes += allocationsAfter.numOfBytes - allocationsBefore.numOfBytes;
+
+		++result.iterations;
+	}
+
+	result.nanoseconds = totalSeconds * 1e9 / result.iterations;
+	result.allocations = double(totalAllocations) / result.iterations;
+	result.bytes = double(totalBytes) / result.iterations;
+	return result;
+}
+
+//Triangulates the same points with the Hilbert insert order and with the points going in by index, one after the other
+//so both see the same machine noise. The points are spread out at random like freshly spawned rooms, so by index they jump all over.
+void RunInsertOrderBenchmark(int numOfRooms, const BenchmarkSettings& settings, BenchmarkResult& hilbertResult, BenchmarkResult& indexResult)
+{
+	hilbertResult = BenchmarkResult{};
+	hilbertResult.name = CreateInsertOrderBenchmarkName(true, numOfRooms);
+	indexResult = BenchmarkResult{};
+	indexResult.name = CreateInsertOrderBenchmarkName(false, numOfRooms);
+
+	std::vector<std::vector<Vertex>> seedPoints{};
+	for (const unsigned int seed : settings.seeds)
+	{
+		Pcg32 random{ seed, 0 };
+		const float size{ std::sqrt(float(numOfRooms)) * 100.f };
+		std::vector<Vertex> points{};
+		for (int roomIdx{}; roomIdx < numOfRooms; ++roomIdx)
+			points.emplace_back(float(random.Next()) / 4294967296.f * size, float(random.Next()) / 4294967296.f * size, roomIdx);
+		seedPoints.emplace_back(points);
+	}
+
+	Graph graph{};
+	double hilbertSeconds{}, indexSeconds{};
+	long long hilbertAllocations{}, hilbertBytes{}, indexAllocations{}, indexBytes{};
+	const auto benchmarkStartTime{ std::chrono::steady_clock::now() };
+
+	auto Measure = [&](const std::vector<Vertex>& points, bool isHilbertOrdered, double& seconds, long long& allocations, long long& bytes)
+	{
+		graph.SetPoints(points);
+
+		const utils::AllocationStats allocationsBefore{ utils::GetAllocationStats() };
+		const auto startTime{ std::chrono::steady_clock::now() };
+
+		graph.BeginTriangulation(isHilbertOrdered);
+		graph.ContinueTriangulation(int(points.size()));
+
+		seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		const utils::AllocationStats allocationsAfter{ utils::GetAllocationStats() };
+		allocations += allocationsAfter.numOfAllocations - allocationsBefore.numOfAllocations;
+		bytes += allocationsAfter.numOfBytes - allocationsBefore.numOfBytes;
+	};
+
+	int iterations{};
+	while (iterations == 0 || (iterations < settings.maxIterations && std::min(hilbertSeconds, indexSeconds) < settings.minSeconds
+		&& std::chrono::duration<double>(std::chrono::steady_clock::now() - benchmarkStartTime).count() < settings.maxWallSeconds))
+	{
+		const std::vector<Vertex>& points{ seedPoints[iterations % seedPoints.size()] };
+		Measure(points, true, hilbertSeconds, hilbertAllocations, hilbertBytes);
+		Measure(points, false, indexSeconds, indexAllocations, indexBytes);
+		++iterations;
+	}
+
+	hilbertResult.iterations = indexResult.iterations = iterations;
+	hilbertResult.nanoseconds = hilbertSeconds * 1e9 / iterations;
+	hilbertResult.allocations = double(hilbertAllocations) / iterations;
+	hilbertResult.bytes = double(hilbertBytes) / iterations;
+	indexResult.nanoseconds = indexSeconds * 1e9 / iterations;
+	indexResult.allocations = double(indexAllocations) / iterations;
+	indexResult.bytes = double(indexBytes) / iterations;
+}
+
+bool SaveBaseline(const std::string& path, const std::vector<BenchmarkResult>& results)
+{
+	std::ofstream file{ path };
+	if (!file) return false;
+
+	file << std::fixed << std::setprecision(1);
+	for (const auto& result : results)
+		file << result.name << ' ' << result.nanoseconds << ' ' << result.allocations << ' ' << result.bytes << '\n';
+	return true;
+}
+
+bool LoadBaseline(const std::string& path, std::map<std::string, BenchmarkResult>& baseline)
+{
+	std::ifstream file{ path };
+	if (!file) return false;
+
+	BenchmarkResult result{};
+	while (file >> result.name >> result.nanoseconds >> result.allocations >> result.bytes)
+		baseline[result.name] = result;
+	return true;
+}
+
+std::string FormatChange(double current, double previous)
+{
+	if (previous <= 0.0) return current > 0.0 ? "new" : "=";
+
+	std::ostringstream stream{};
+	const double change{ (current - previous) / previous * 100.0 };
+	stream << std::showpos << std::fixed << std::setprecision(1) << change << '%';
+	return stream.str();
+}
+
+int main(int argc, char* argv[])
+{
+	BenchmarkSettings settings{};
+	if (!ParseArguments(argc, argv, settings))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	std::map<std::string, BenchmarkResult> baseline{};
+	const bool doCompare{ !settings.comparePath.empty() };
+	if (doCompare && !LoadBaseline(settings.comparePath, baseline))
+	{
+		std::cerr << "Could not read the baseline " << settings.comparePath << std::endl;
+		return 1;
+	}
+
+	std::cout << std::left << std::setw(32) << "Benchmark" << std::right << std::setw(8) << "Iters"
+		<< std::setw(16) << "ns/op" << std::setw(14) << "allocs/op" << std::setw(14) << "bytes/op";
+	if (doCompare) std::cout << std::setw(12) << "ns" << std::setw(12) << "allocs";
+	std::cout << std::endl;
+
+	DungeonGenerator generator{};
+	std::vector<BenchmarkResult> results{};
+	int numOfRegressions{};
+
+	auto ReportResult = [&](const BenchmarkResult& result)
+	{
+		results.emplace_back(result);
+
+		std::cout << std::left << std::setw(32) << result.name << std::right << std::setw(8) << result.iterations
+			<< std::fixed << std::setprecision(0) << std::setw(16) << result.nanoseconds
+			<< std::setprecision(1) << std::setw(14) << result.allocations << std::setw(14) << result.bytes;
+
+		if (doCompare)
+		{
+			const auto it{ baseline.find(result.name) };
+			if (it != baseline.end())
+			{
+				std::cout << std::setw(12) << FormatChange(result.nanoseconds, it->second.nanoseconds)
+					<< std::setw(12) << FormatChange(result.allocations, it->second.allocations);
+
+				const bool isSlower{ result.nanoseconds > it->second.nanoseconds * (1.0 + settings.regressionPercentage / 100.0) };
+				//Allocation counts are averaged over the seeds, allow for a little noise there as well
+				const bool hasMoreAllocations{ result.allocations > it->second.allocations * (1.0 + settings.regressionPercentage / 100.0) + 0.5 };
+				if (isSlower || hasMoreAllocations)
+				{
+					std::cout << "  REGRESSION";
+					++numOfRegressions;
+				}
+			}
+			else
+			{
+				std::cout << std::setw(12) << "new" << std::setw(12) << "new";
+			}
+		}
+		std::cout << std::endl;
+	};
+
+	for (int stage{}; stage < DungeonGenerator::done; ++stage)
+	{
+		for (const int numOfRooms : settings.roomCounts)
+		{
+			if (numOfRooms > settings.maxRooms) continue;
+			if (CreateBenchmarkName(DungeonGenerator::Stage(stage), numOfRooms).find(settings.filter) == std::string::npos) continue;
+
+			ReportResult(RunStageBenchmark(generator, DungeonGenerator::Stage(stage), numOfRooms, settings));
+		}
+	}
+
+	for (const int numOfRooms : settings.roomCounts)
+	{
+		if (numOfRooms > settings.maxRooms) continue;
+		if (CreatePipelineBenchmarkName(numOfRooms).find(settings.filter) == std::string::npos) continue;
+
+		ReportResult(RunPipelineBenchmark(generator, numOfRooms, settings));
+	}
+
+	for (const int numOfRooms : settings.roomCounts)
+	{
+		if (numOfRooms > settings.maxRooms) continue;
+		if (CreateInsertOrderBenchmarkName(true, numOfRooms).find(settings.filter) == std::string::npos
+			&& CreateInsertOrderBenchmarkName(false, numOfRooms).find(settings.filter) == std::string::npos) continue;
+
+		BenchmarkResult hilbertResult{}, indexResult{};
+		RunInsertOrderBenchmark(numOfRooms, settings, hilbertResult, indexResult);
+		ReportResult(hilbertResult);
+		ReportResult(indexResult);
+		std::cout << "  Hilbert order speedup at " << numOfRooms << " rooms: " << std::fixed << std::setprecision(2)
+			<< indexResult.nanoseconds / hilbertResult.nanoseconds << 'x' << std::endl;
+	}
+
+	if (!settings.savePath.empty())
+	{
+		if (!SaveBaseline(settings.savePath, results))
+		{
+			std::cerr << "Could not write the baseline " << settings.savePath << std::endl;
+			return 1;
+		}
+		std::cout << "Saved the baseline to " << settings.savePath << std::endl;
+	}
+
+	if (doCompare)
+	{
+		std::cout << numOfRegressions << " regression(s) compared to " << settings.comparePath << std::endl;
+		if (numOfRegressions > 0) return 2;
+	}
+	return 0;
+}
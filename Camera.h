@@ -1,10 +1,14 @@
 #pragma once
 #include "pch.h"
 
+#include <algorithm>
+
 class Camera
 {
 public:
 	Camera(float width, float height)
+		:m_Width{ width }
+		,m_Height{ height }
 	{
 		
 	}
@@ -24,36 +28,41 @@ public:
 
 	Point2f GetClampedTarget() { return m_ClampedPoint; }
 
-	void Clamp(Point2f& bottomLeft)
+	//The part of the level that is on screen, in world space
+	Rectf GetViewRect() const
+	{
+		return Rectf{ m_ClampedPoint.x, m_ClampedPoint.y, m_Width / m_Zoom, m_Height / m_Zoom };
+	}
+
+	Point2f ScreenToWorld(const Point2f& screenPos) const
+	{
+		return Point2f{ m_ClampedPoint.x + screenPos.x / m_Zoom, m_ClampedPoint.y + screenPos.y / m_Zoom };
+	}
+
+	void Clamp(Point2f& bottomLeft) const
 	{
-		if (bottomLeft.x < m_LevelBoundaries.left)
-		{
-			bottomLeft.x = m_LevelBoundaries.left;
-		}
-
-		if (bottomLeft.y < m_LevelBoundaries.bottom)
-		{
-			bottomLeft.y = m_LevelBoundaries.bottom;
-		}
-
-		if (bottomLeft.x + m_Width >= m_LevelBoundaries.width)
-		{
-			bottomLeft.x = m_LevelBoundaries.width - m_Width;
-		}
-
-		if (bottomLeft.y + m_Height >= m_LevelBoundaries.height)
-		{
-			bottomLeft.y = m_LevelBoundaries.height - m_Height;
-		}
+		//Zooming in makes the view smaller in world space, so it can move further
+		bottomLeft.x = ClampAxis(bottomLeft.x, m_LevelBoundaries.left, m_LevelBoundaries.width, m_Width / m_Zoom);
+		bottomLeft.y = ClampAxis(bottomLeft.y, m_LevelBoundaries.bottom, m_LevelBoundaries.height, m_Height / m_Zoom);
 	}
 
 	void SetLevelBoundaries(const Rectf& levelBoundaries) { m_LevelBoundaries = levelBoundaries; }
+	void SetZoom(float zoom) { m_Zoom = zoom; }
 
 private:
 	Rectf m_LevelBoundaries{};
 	float m_Width{};
 	float m_Height{};
+	float m_Zoom{ 1.f };
 
 	Point2f m_ClampedPoint{};
 
-};
\ No newline at end of file
+	static float ClampAxis(float position, float levelStart, float levelSize, float viewSize)
+	{
+		//When the whole level fits on screen it stays in the middle
+		if (viewSize >= levelSize)
+			return levelStart + levelSize / 2.f - viewSize / 2.f;
+
+		return std::max(levelStart, std::min(position, levelStart + levelSize - viewSize));
+	}
+};
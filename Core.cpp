@@ -198,6 +198,7 @@ void Core::Run( )
 
 			// Draw in the back buffer
 			pGame->Draw();
+			utils::FlushDrawBatch();
 
 			// Update screen: swap back and front buffer
 			SDL_GL_SwapWindow(m_pWindow);
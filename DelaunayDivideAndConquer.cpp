@@ -0,0 +1,236 @@
+#include "DelaunayDivideAndConquer.h"
+
+#include <cstdint>
+#include <utility>
+
+#include "Predicates.h"
+#include "ThreadPool.h"
+
+void DelaunayDivideAndConquer::Triangulate(const std::vector<double>& xs, const std::vector<double>& ys, ThreadPool* pPool)
+{
+	m_pXs = xs.data();
+	m_pYs = ys.data();
+	m_Next.clear();
+	m_Origins.clear();
+
+	const int numOfPoints{ int(xs.size()) };
+	if (numOfPoints < 2) return;
+
+	//A power of two, so the strips merge in pairs all the way up
+	const int maxNumOfStrips{ pPool ? pPool->GetNumOfThreads() * m_StripsPerThread : 1 };
+	int numOfStrips{ 1 };
+	while (numOfStrips * 2 <= maxNumOfStrips && numOfPoints / (numOfStrips * 2) >= m_MinPointsPerStrip)
+		numOfStrips *= 2;
+	auto GetStripStart = [&](int strip) { return int(int64_t(numOfPoints) * strip / numOfStrips); };
+
+	//A triangulation of n points never has more than 3n edges at once, with the deleted ones reused that is enough for a strip.
+	//A merge only adds the edges between the two halves, which is at most one per point
+	m_Arenas.resize(size_t(numOfStrips) * 2 - 1);
+	int numOfRecords{};
+	for (int strip{}; strip < numOfStrips; ++strip)
+	{
+		const int size{ GetStripStart(strip + 1) - GetStripStart(strip) };
+		m_Arenas[strip].next = numOfRecords;
+		m_Arenas[strip].end = numOfRecords += 3 * size + 3;
+		m_Arenas[strip].freeRecords.clear();
+	}
+	int arenaIdx{ numOfStrips };
+	for (int width{ 1 }; width < numOfStrips; width *= 2)
+	{
+		for (int strip{}; strip < numOfStrips; strip += 2 * width)
+		{
+			const int size{ GetStripStart(strip + 2 * width) - GetStripStart(strip) };
+			m_Arenas[arenaIdx].next = numOfRecords;
+			m_Arenas[arenaIdx].end = numOfRecords += size + 2;
+			m_Arenas[arenaIdx].freeRecords.clear();
+			++arenaIdx;
+		}
+	}
+	m_Next.resize(size_t(numOfRecords) * 4);
+	m_Origins.assign(size_t(numOfRecords) * 2, -1);
+	m_Hulls.resize(numOfStrips);
+
+	auto Run = [pPool](auto task)
+	{
+		if (pPool) pPool->Enqueue(task);
+		else task();
+	};
+
+	for (int strip{}; strip < numOfStrips; ++strip)
+	{
+		Run([this, strip, GetStripStart]()
+			{
+				m_Hulls[strip] = TriangulateRange(GetStripStart(strip), GetStripStart(strip + 1), m_Arenas[strip]);
+			});
+	}
+	if (pPool) pPool->Wait();
+
+	//The merges of one level only touch their own two strips, the next level waits for them
+	arenaIdx = numOfStrips;
+	for (int width{ 1 }; width < numOfStrips; width *= 2)
+	{
+		for (int strip{}; strip < numOfStrips; strip += 2 * width)
+		{
+			Run([this, strip, width, arenaIdx]()
+				{
+					m_Hulls[strip] = Merge(m_Hulls[strip], m_Hulls[strip + width], m_Arenas[arenaIdx]);
+				});
+			++arenaIdx;
+		}
+		if (pPool) pPool->Wait();
+	}
+}
+
+DelaunayDivideAndConquer::Hull DelaunayDivideAndConquer::TriangulateRange(int firstPoint, int endPoint, EdgeArena& arena)
+{
+	const int numOfPoints{ endPoint - firstPoint };
+	if (numOfPoints == 2)
+	{
+		const int edge{ MakeEdge(firstPoint, firstPoint + 1, arena) };
+		return Hull{ edge, Sym(edge) };
+	}
+
+	if (numOfPoints == 3)
+	{
+		const int pointA{ firstPoint }, pointB{ firstPoint + 1 }, pointC{ firstPoint + 2 };
+		const int edgeA{ MakeEdge(pointA, pointB, arena) };
+		const int edgeB{ MakeEdge(pointB, pointC, arena) };
+		Splice(Sym(edgeA), edgeB);
+
+		//Close the triangle, unless the points are on one line
+		if (IsCounterClockwise(pointA, pointB, pointC))
+		{
+			Connect(edgeB, edgeA, arena);
+			return Hull{ edgeA, Sym(edgeB) };
+		}
+		if (IsCounterClockwise(pointA, pointC, pointB))
+		{
+			const int edgeC{ Connect(edgeB, edgeA, arena) };
+			return Hull{ Sym(edgeC), edgeC };
+		}
+		return Hull{ edgeA, Sym(edgeB) };
+	}
+
+	//Both halves have at least two points
+	const int middlePoint{ firstPoint + numOfPoints / 2 };
+	const Hull left{ TriangulateRange(firstPoint, middlePoint, arena) };
+	const Hull right{ TriangulateRange(middlePoint, endPoint, arena) };
+	return Merge(left, right, arena);
+}
+
+DelaunayDivideAndConquer::Hull DelaunayDivideAndConquer::Merge(const Hull& left, const Hull& right, EdgeArena& arena)
+{
+	int leftOuter{ left.leftEdge }, leftInner{ left.rightEdge };
+	int rightInner{ right.leftEdge }, rightOuter{ right.rightEdge };
+
+	//Find the lower common tangent of the two hulls
+	while (true)
+	{
+		if (IsLeftOf(Org(rightInner), leftInner)) leftInner = Lnext(leftInner);
+		else if (IsRightOf(Org(leftInner), rightInner)) rightInner = Rprev(rightInner);
+		else break;
+	}
+
+	int baseEdge{ Connect(Sym(rightInner), leftInner, arena) };
+	if (Org(leftInner) == Org(leftOuter)) leftOuter = Sym(baseEdge);
+	if (Org(rightInner) == Org(rightOuter)) rightOuter = baseEdge;
+
+	//Zip the halves together from the bottom up, removing the edges the new triangles make non Delaunay
+	auto IsValid = [this, &baseEdge](int edge) { return IsCounterClockwise(Dest(edge), Dest(baseEdge), Org(baseEdge)); };
+	while (true)
+	{
+		int leftCandidate{ Onext(Sym(baseEdge)) };
+		if (IsValid(leftCandidate))
+		{
+			while (IsInCircle(Dest(baseEdge), Org(baseEdge), Dest(leftCandidate), Dest(Onext(leftCandidate))))
+			{
+				const int nextCandidate{ Onext(leftCandidate) };
+				DeleteEdge(leftCandidate, arena);
+				leftCandidate = nextCandidate;
+			}
+		}
+
+		int rightCandidate{ Oprev(baseEdge) };
+		if (IsValid(rightCandidate))
+		{
+			while (IsInCircle(Dest(baseEdge), Org(baseEdge), Dest(rightCandidate), Dest(Oprev(rightCandidate))))
+			{
+				const int nextCandidate{ Oprev(rightCandidate) };
+				DeleteEdge(rightCandidate, arena);
+				rightCandidate = nextCandidate;
+			}
+		}
+
+		const bool isLeftValid{ IsValid(leftCandidate) }, isRightValid{ IsValid(rightCandidate) };
+		if (!isLeftValid && !isRightValid) break;
+
+		if (!isLeftValid || (isRightValid && IsInCircle(Dest(leftCandidate), Org(leftCandidate), Org(rightCandidate), Dest(rightCandidate))))
+			baseEdge = Connect(rightCandidate, Sym(baseEdge), arena);
+		else
+			baseEdge = Connect(Sym(baseEdge), Sym(leftCandidate), arena);
+	}
+
+	return Hull{ leftOuter, rightOuter };
+}
+
+int DelaunayDivideAndConquer::MakeEdge(int originPoint, int destinationPoint, EdgeArena& arena)
+{
+	int record{};
+	if (!arena.freeRecords.empty())
+	{
+		record = arena.freeRecords.back();
+		arena.freeRecords.pop_back();
+	}
+	else
+	{
+		//The arena sizes are upper bounds, this never runs past the end
+		record = arena.next++;
+	}
+
+	const int edge{ record * 4 };
+	m_Next[edge] = edge;
+	m_Next[edge + 1] = edge + 3;
+	m_Next[edge + 2] = edge + 2;
+	m_Next[edge + 3] = edge + 1;
+	m_Origins[record * 2] = originPoint;
+	m_Origins[record * 2 + 1] = destinationPoint;
+	return edge;
+}
+
+void DelaunayDivideAndConquer::DeleteEdge(int edge, EdgeArena& arena)
+{
+	Splice(edge, Oprev(edge));
+	Splice(Sym(edge), Oprev(Sym(edge)));
+
+	const int record{ edge >> 2 };
+	m_Origins[record * 2] = -1;
+	arena.freeRecords.emplace_back(record);
+}
+
+void DelaunayDivideAndConquer::Splice(int edgeA, int edgeB)
+{
+	const int alpha{ Rot(Onext(edgeA)) };
+	const int beta{ Rot(Onext(edgeB)) };
+	std::swap(m_Next[edgeA], m_Next[edgeB]);
+	std::swap(m_Next[alpha], m_Next[beta]);
+}
+
+int DelaunayDivideAndConquer::Connect(int edgeA, int edgeB, EdgeArena& arena)
+{
+	//From the end of edgeA to the start of edgeB, with the same face on the left
+	const int edge{ MakeEdge(Dest(edgeA), Org(edgeB), arena) };
+	Splice(edge, Lnext(edgeA));
+	Splice(Sym(edge), edgeB);
+	return edge;
+}
+
+bool DelaunayDivideAndConquer::IsCounterClockwise(int pointA, int pointB, int pointC) const
+{
+	return utils::Orient2d(m_pXs[pointA], m_pYs[pointA], m_pXs[pointB], m_pYs[pointB], m_pXs[pointC], m_pYs[pointC]) > 0.0;
+}
+
+bool DelaunayDivideAndConquer::IsInCircle(int pointA, int pointB, int pointC, int pointD) const
+{
+	return utils::InCircleWithTies(m_pXs[pointA], m_pYs[pointA], m_pXs[pointB], m_pYs[pointB],
+		m_pXs[pointC], m_pYs[pointC], m_pXs[pointD], m_pYs[pointD]) > 0.0;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <vector>
+
+class ThreadPool;
+
+//Guibas-Stolfi divide and conquer Delaunay triangulation on a quad edge structure.
+//The points are cut into strips that are triangulated at the same time, then neighbouring strips are merged in pairs,
+//with all merges of a level running at the same time as well. Every strip and merge gets its own part of the edge storage,
+//so two tasks never touch the same edges.
+class DelaunayDivideAndConquer final
+{
+public:
+	DelaunayDivideAndConquer() = default;
+
+	//The points have to be sorted on x and then on y, without duplicates. Without a pool everything runs on the calling thread
+	void Triangulate(const std::vector<double>& xs, const std::vector<double>& ys, ThreadPool* pPool);
+
+	//Calls function(pointA, pointB) once for every edge
+	template<typename Function>
+	void ForEachEdge(Function function) const
+	{
+		for (int record{}; record < int(m_Origins.size()) / 2; ++record)
+		{
+			if (m_Origins[record * 2] != -1)
+				function(m_Origins[record * 2], m_Origins[record * 2 + 1]);
+		}
+	}
+
+private:
+	static constexpr int m_MinPointsPerStrip{ 1024 };
+	static constexpr int m_StripsPerThread{ 4 }; //More strips than threads evens out strips that take longer
+
+	//The counter clockwise hull edge out of the leftmost point and the clockwise one out of the rightmost point
+	struct Hull
+	{
+		int leftEdge;
+		int rightEdge;
+	};
+
+	//Edge records [next, end) that were not used yet, and the ones that were deleted and can be used again
+	struct EdgeArena
+	{
+		int next;
+		int end;
+		std::vector<int> freeRecords;
+	};
+
+	const double* m_pXs{};
+	const double* m_pYs{};
+
+	//An edge record has four quarter edges, the edge in both directions and its two duals. Quarter edge e is in record e / 4
+	std::vector<int> m_Next{}; //Next quarter edge counter clockwise around the same origin
+	std::vector<int> m_Origins{}; //Two per record, the origin of the edge and of its opposite. -1 when the record is not used
+	std::vector<EdgeArena> m_Arenas{};
+	std::vector<Hull> m_Hulls{};
+
+	Hull TriangulateRange(int firstPoint, int endPoint, EdgeArena& arena);
+	Hull Merge(const Hull& left, const Hull& right, EdgeArena& arena);
+
+	int MakeEdge(int originPoint, int destinationPoint, EdgeArena& arena);
+	void DeleteEdge(int edge, EdgeArena& arena);
+	void Splice(int edgeA, int edgeB);
+	int Connect(int edgeA, int edgeB, EdgeArena& arena);
+
+	static int Rot(int edge) { return (edge & ~3) | ((edge + 1) & 3); }
+	static int Sym(int edge) { return (edge & ~3) | ((edge + 2) & 3); }
+	static int InvRot(int edge) { return (edge & ~3) | ((edge + 3) & 3); }
+	int Onext(int edge) const { return m_Next[edge]; }
+	int Oprev(int edge) const { return Rot(m_Next[Rot(edge)]); }
+	int Lnext(int edge) const { return Rot(m_Next[InvRot(edge)]); }
+	int Rprev(int edge) const { return m_Next[Sym(edge)]; }
+	int Org(int edge) const { return m_Origins[(edge >> 2) * 2 + ((edge & 3) >> 1)]; }
+	int Dest(int edge) const { return Org(Sym(edge)); }
+
+	bool IsCounterClockwise(int pointA, int pointB, int pointC) const;
+	//True when pointD is inside of the circle through the counter clockwise pointA, pointB and pointC, ties are broken like the mesh does
+	bool IsInCircle(int pointA, int pointB, int pointC, int pointD) const;
+	bool IsRightOf(int point, int edge) const { return IsCounterClockwise(point, Dest(edge), Org(edge)); }
+	bool IsLeftOf(int point, int edge) const { return IsCounterClockwise(point, Org(edge), Dest(edge)); }
+};
@@ -0,0 +1,755 @@
+#include "DelaunayMesh.h"
+#include "Predicates.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void DelaunayMesh::Begin(float minX, float minY, float maxX, float maxY, int numOfPointsToReserve)
+{
+	Clear();
+
+	//Every point adds two triangles
+	m_PointsX.reserve(numOfPointsToReserve + m_NumOfSuperVertices);
+	m_PointsY.reserve(numOfPointsToReserve + m_NumOfSuperVertices);
+	m_TriangleByVertex.reserve(numOfPointsToReserve + m_NumOfSuperVertices);
+	m_Triangles.reserve(2 * numOfPointsToReserve + 1);
+
+	for (int i{}; i < m_NumOfSuperVertices; ++i)
+		AddVertex(0.0, 0.0);
+	SetSuperTriangle(minX, minY, maxX, maxY);
+}
+
+void DelaunayMesh::Clear()
+{
+	m_PointsX.clear();
+	m_PointsY.clear();
+	m_TriangleByVertex.clear();
+	m_Triangles.clear();
+	m_FreeVertices.clear();
+	m_FreeTriangles.clear();
+	m_TriangleStamps.clear();
+	m_CurrentStamp = 0;
+	m_LastTriangle = -1;
+	m_IsTrackingEdgeChanges = false;
+	m_AddedEdgeKeys.clear();
+	m_RemovedEdgeKeys.clear();
+	m_AddedTriangles.clear();
+	m_RemovedTriangles.clear();
+}
+
+void DelaunayMesh::SetTrackingEdgeChanges(bool isTracking)
+{
+	m_IsTrackingEdgeChanges = isTracking;
+	m_AddedEdgeKeys.clear();
+	m_RemovedEdgeKeys.clear();
+	m_AddedTriangles.clear();
+	m_RemovedTriangles.clear();
+}
+
+void DelaunayMesh::TakeEdgeChanges(std::vector<std::pair<int, int>>& addedEdges, std::vector<std::pair<int, int>>& removedEdges)
+{
+	addedEdges.clear();
+	removedEdges.clear();
+
+	std::sort(m_AddedEdgeKeys.begin(), m_AddedEdgeKeys.end());
+	std::sort(m_RemovedEdgeKeys.begin(), m_RemovedEdgeKeys.end());
+
+	//Only the difference between how many times an edge got added and removed says whether it changed
+	size_t addedIdx{}, removedIdx{};
+	while (addedIdx < m_AddedEdgeKeys.size() || removedIdx < m_RemovedEdgeKeys.size())
+	{
+		uint64_t key{ std::numeric_limits<uint64_t>::max() };
+		if (addedIdx < m_AddedEdgeKeys.size()) key = m_AddedEdgeKeys[addedIdx];
+		if (removedIdx < m_RemovedEdgeKeys.size()) key = std::min(key, m_RemovedEdgeKeys[removedIdx]);
+
+		int count{};
+		for (; addedIdx < m_AddedEdgeKeys.size() && m_AddedEdgeKeys[addedIdx] == key; ++addedIdx)
+			++count;
+		for (; removedIdx < m_RemovedEdgeKeys.size() && m_RemovedEdgeKeys[removedIdx] == key; ++removedIdx)
+			--count;
+
+		const std::pair<int, int> edge{ int(key >> 32) - m_NumOfSuperVertices, int(key & 0xFFFFFFFFu) - m_NumOfSuperVertices };
+		if (count > 0) addedEdges.emplace_back(edge);
+		else if (count < 0) removedEdges.emplace_back(edge);
+	}
+
+	m_AddedEdgeKeys.clear();
+	m_RemovedEdgeKeys.clear();
+}
+
+void DelaunayMesh::TakeTriangleChanges(std::vector<TriangleCorners>& addedTriangles, std::vector<TriangleCorners>& removedTriangles)
+{
+	addedTriangles.clear();
+	removedTriangles.clear();
+
+	std::sort(m_AddedTriangles.begin(), m_AddedTriangles.end());
+	std::sort(m_RemovedTriangles.begin(), m_RemovedTriangles.end());
+
+	//Like the edges, a triangle that went away and came back is in neither
+	size_t addedIdx{}, removedIdx{};
+	while (addedIdx < m_AddedTriangles.size() || removedIdx < m_RemovedTriangles.size())
+	{
+		const bool isAddedFirst{ removedIdx == m_RemovedTriangles.size()
+			|| (addedIdx < m_AddedTriangles.size() && !(m_RemovedTriangles[removedIdx] < m_AddedTriangles[addedIdx])) };
+		const TriangleCorners corners{ isAddedFirst ? m_AddedTriangles[addedIdx] : m_RemovedTriangles[removedIdx] };
+
+		int count{};
+		for (; addedIdx < m_AddedTriangles.size() && m_AddedTriangles[addedIdx] == corners; ++addedIdx)
+			++count;
+		for (; removedIdx < m_RemovedTriangles.size() && m_RemovedTriangles[removedIdx] == corners; ++removedIdx)
+			--count;
+
+		if (count > 0) addedTriangles.emplace_back(corners);
+		else if (count < 0) removedTriangles.emplace_back(corners);
+	}
+
+	m_AddedTriangles.clear();
+	m_RemovedTriangles.clear();
+}
+
+int DelaunayMesh::InsertPoint(float x, float y)
+{
+	if (m_LastTriangle == -1) return -1;
+
+	const bool isReused{ !m_FreeVertices.empty() };
+	int vertex{};
+	if (isReused)
+	{
+		vertex = m_FreeVertices.back();
+		m_FreeVertices.pop_back();
+	}
+	else
+	{
+		vertex = AddVertex(std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN());
+	}
+
+	if (InsertVertex(vertex, x, y)) return vertex - m_NumOfSuperVertices;
+
+	//Duplicates do not take up an index
+	if (isReused)
+	{
+		m_FreeVertices.emplace_back(vertex);
+	}
+	else
+	{
+		m_PointsX.pop_back();
+		m_PointsY.pop_back();
+		m_TriangleByVertex.pop_back();
+	}
+	return -1;
+}
+
+int DelaunayMesh::FindPoint(float x, float y) const
+{
+	if (m_LastTriangle == -1) return -1;
+
+	//The triangle Locate ends up in has the point as a corner, the same check keeps duplicates out of the mesh
+	const int triangleIdx{ Locate(x, y) };
+	if (triangleIdx == -1) return -1;
+
+	for (const int vertex : m_Triangles[triangleIdx].vertices)
+	{
+		if (vertex >= m_NumOfSuperVertices && m_PointsX[vertex] == double(x) && m_PointsY[vertex] == double(y))
+			return vertex - m_NumOfSuperVertices;
+	}
+	return -1;
+}
+
+bool DelaunayMesh::RemovePoint(int pointIdx)
+{
+	const int vertex{ pointIdx + m_NumOfSuperVertices };
+	if (!IsPoint(vertex)) return false;
+
+	CollectStar(vertex, FindTriangleWithVertex(vertex));
+	FillStar();
+
+	m_PointsX[vertex] = m_PointsY[vertex] = std::numeric_limits<double>::quiet_NaN();
+	m_FreeVertices.emplace_back(vertex);
+	return true;
+}
+
+bool DelaunayMesh::MovePoint(int pointIdx, float x, float y)
+{
+	const int vertex{ pointIdx + m_NumOfSuperVertices };
+	if (!IsPoint(vertex)) return false;
+
+	const double pointX{ x }, pointY{ y };
+	if (m_PointsX[vertex] == pointX && m_PointsY[vertex] == pointY) return true;
+
+	CollectStar(vertex, FindTriangleWithVertex(vertex));
+
+	//As long as the point sees every edge of the polygon around it from the inside, none of its triangles turn over.
+	//Only the edges of those triangles can stop being Delaunay then, and flipping those until they are fixes the mesh.
+	bool isInsideStar{ true };
+	for (const auto& edge : m_Boundary)
+	{
+		if (Orientation(edge.vertexA, edge.vertexB, pointX, pointY) <= 0.0)
+		{
+			isInsideStar = false;
+			break;
+		}
+	}
+
+	if (isInsideStar)
+	{
+		m_PointsX[vertex] = pointX;
+		m_PointsY[vertex] = pointY;
+
+		m_EdgesToCheck.clear();
+		for (const int triangleIdx : m_Cavity)
+		{
+			const Triangle& triangle{ m_Triangles[triangleIdx] };
+			if (m_IsTrackingEdgeChanges) TrackTriangle(triangleIdx, false);
+			SetTriangle(triangleIdx, triangle.vertices[0], triangle.vertices[1], triangle.vertices[2]);
+			for (int i{}; i < 3; ++i)
+				m_EdgesToCheck.emplace_back(TriangleEdge{ triangleIdx, triangle.vertices[(i + 1) % 3], triangle.vertices[(i + 2) % 3] });
+		}
+		FlipUntilDelaunay();
+		return true;
+	}
+
+	//Further away it is easier to take the point out and put it back in the same slot
+	FillStar();
+	m_PointsX[vertex] = m_PointsY[vertex] = std::numeric_limits<double>::quiet_NaN();
+	if (InsertVertex(vertex, pointX, pointY)) return true;
+
+	m_FreeVertices.emplace_back(vertex);
+	return false;
+}
+
+bool DelaunayMesh::InsertVertex(int vertex, double x, double y)
+{
+	if (!FindCavity(x, y))
+	{
+		if (IsInsideSuperTriangle(x, y)) return false;
+
+		GrowSuperTriangle(x, y);
+		if (!FindCavity(x, y)) return false;
+	}
+
+	m_PointsX[vertex] = x;
+	m_PointsY[vertex] = y;
+	FanCavity(vertex);
+	return true;
+}
+
+bool DelaunayMesh::FindCavity(double x, double y)
+{
+	const int startTriangle{ Locate(x, y) };
+	if (startTriangle == -1) return false;
+
+	//Points on top of an existing point are skipped
+	for (const int vertex : m_Triangles[startTriangle].vertices)
+	{
+		if (m_PointsX[vertex] == x && m_PointsY[vertex] == y) return false;
+	}
+
+	//Flood fill from the triangle that holds the point to find every triangle whose circum circle holds it.
+	//It grows a ring at a time, so the neighbours of the whole ring can be tested against the point in batches
+	++m_CurrentStamp;
+	m_Stack.clear();
+	m_Cavity.clear();
+	m_Boundary.clear();
+
+	m_Stack.emplace_back(startTriangle);
+	m_TriangleStamps[startTriangle] = m_CurrentStamp;
+
+	while (!m_Stack.empty())
+	{
+		m_CavityEdges.clear();
+		for (const int triangleIdx : m_Stack)
+		{
+			m_Cavity.emplace_back(triangleIdx);
+
+			const Triangle& triangle{ m_Triangles[triangleIdx] };
+			for (int i{}; i < 3; ++i)
+			{
+				const int neighbour{ triangle.neighbours[i] };
+				if (neighbour != -1 && m_TriangleStamps[neighbour] == m_CurrentStamp) continue;
+
+				m_CavityEdges.emplace_back(BoundaryEdge{ triangle.vertices[(i + 1) % 3], triangle.vertices[(i + 2) % 3], neighbour });
+			}
+		}
+		m_Stack.clear();
+
+		const int numOfEdges{ int(m_CavityEdges.size()) };
+		for (int firstIdx{}; firstIdx < numOfEdges; firstIdx += utils::g_CirclesPerBatch)
+		{
+			const int numOfCircles{ std::min(utils::g_CirclesPerBatch, numOfEdges - firstIdx) };
+			for (int lane{}; lane < numOfCircles; ++lane)
+			{
+				//Outside of the super triangle there is nothing to test, the lane only gets filled so it holds numbers
+				const int neighbour{ m_CavityEdges[firstIdx + lane].outsideTriangle };
+				if (neighbour == -1)
+				{
+					m_CircleBatch.ax[lane] = m_CircleBatch.bx[lane] = m_CircleBatch.cx[lane] = x;
+					m_CircleBatch.ay[lane] = m_CircleBatch.by[lane] = m_CircleBatch.cy[lane] = y;
+					continue;
+				}
+
+				const int* pVertices{ m_Triangles[neighbour].vertices };
+				m_CircleBatch.ax[lane] = m_PointsX[pVertices[0]];
+				m_CircleBatch.ay[lane] = m_PointsY[pVertices[0]];
+				m_CircleBatch.bx[lane] = m_PointsX[pVertices[1]];
+				m_CircleBatch.by[lane] = m_PointsY[pVertices[1]];
+				m_CircleBatch.cx[lane] = m_PointsX[pVertices[2]];
+				m_CircleBatch.cy[lane] = m_PointsY[pVertices[2]];
+			}
+
+			unsigned int uncertainMask{};
+			const unsigned int insideMask{ utils::PointInCircles(x, y, m_CircleBatch, numOfCircles, uncertainMask) };
+
+			for (int lane{}; lane < numOfCircles; ++lane)
+			{
+				const BoundaryEdge& edge{ m_CavityEdges[firstIdx + lane] };
+				const int neighbour{ edge.outsideTriangle };
+
+				//Two triangles of the ring can share a neighbour that is already in the cavity
+				if (neighbour != -1 && m_TriangleStamps[neighbour] == m_CurrentStamp) continue;
+
+				const unsigned int laneBit{ 1u << lane };
+				const bool isInside{ neighbour != -1
+					&& ((insideMask & laneBit) != 0 || ((uncertainMask & laneBit) != 0 && IsInCircumCircle(neighbour, x, y))) };
+
+				//The point has to see every boundary edge from the inside, otherwise the new triangles would overlap.
+				//The exact predicates guarantee that for a Delaunay mesh, growing the cavity over such an edge is only a safety net.
+				if (!isInside && Orientation(edge.vertexA, edge.vertexB, x, y) > 0.0)
+				{
+					m_Boundary.emplace_back(edge);
+					continue;
+				}
+
+				//On the edge of the super triangle
+				if (neighbour == -1) return false;
+
+				m_TriangleStamps[neighbour] = m_CurrentStamp;
+				m_Stack.emplace_back(neighbour);
+			}
+		}
+	}
+	return true;
+}
+
+void DelaunayMesh::FanCavity(int vertex)
+{
+	//The boundary always has two more edges than the cavity has triangles, so all of them get reused
+	for (const int triangleIdx : m_Cavity)
+		FreeTriangle(triangleIdx);
+
+	if (int(m_NewTriangleByStart.size()) < int(m_PointsX.size()))
+		m_NewTriangleByStart.resize(m_PointsX.size(), -1);
+
+	//Fan the boundary around the new point
+	for (const auto& edge : m_Boundary)
+	{
+		const int triangleIdx{ CreateTriangle(edge.vertexA, edge.vertexB, vertex) };
+		m_Triangles[triangleIdx].neighbours[2] = edge.outsideTriangle;
+		if (edge.outsideTriangle != -1)
+			ReplaceNeighbour(edge.outsideTriangle, edge.vertexA, edge.vertexB, triangleIdx);
+
+		m_NewTriangleByStart[edge.vertexA] = triangleIdx;
+	}
+
+	//Link the new triangles to each other, the one after (a, b, new) starts at b
+	for (const auto& edge : m_Boundary)
+	{
+		const int triangleIdx{ m_NewTriangleByStart[edge.vertexA] };
+		const int nextTriangleIdx{ m_NewTriangleByStart[edge.vertexB] };
+
+		m_Triangles[triangleIdx].neighbours[0] = nextTriangleIdx;
+		m_Triangles[nextTriangleIdx].neighbours[1] = triangleIdx;
+	}
+
+	m_LastTriangle = m_NewTriangleByStart[m_Boundary.front().vertexA];
+}
+
+bool DelaunayMesh::IsPoint(int vertex) const
+{
+	return vertex >= m_NumOfSuperVertices && vertex < int(m_PointsX.size()) && !std::isnan(m_PointsX[vertex]);
+}
+
+int DelaunayMesh::FindTriangleWithVertex(int vertex) const
+{
+	auto HasVertex = [this, vertex](int triangleIdx)
+	{
+		const Triangle& triangle{ m_Triangles[triangleIdx] };
+		return triangle.vertices[0] == vertex || triangle.vertices[1] == vertex || triangle.vertices[2] == vertex;
+	};
+
+	//Every triangle that is made or changed updates its vertices, and the triangles around a vertex only go away
+	//when new ones take their place, so this always finds one. Searching is only a safety net
+	const int triangleIdx{ m_TriangleByVertex[vertex] };
+	if (triangleIdx != -1 && HasVertex(triangleIdx)) return triangleIdx;
+
+	//Removed triangles have -1 as their first vertex so they never match
+	for (int otherTriangleIdx{}; otherTriangleIdx < int(m_Triangles.size()); ++otherTriangleIdx)
+	{
+		if (HasVertex(otherTriangleIdx)) return otherTriangleIdx;
+	}
+	return -1;
+}
+
+void DelaunayMesh::CollectStar(int vertex, int triangleIdx)
+{
+	m_Cavity.clear();
+	m_Boundary.clear();
+
+	//Every point is inside of the super triangle, so the triangles around it always close up
+	const int firstTriangleIdx{ triangleIdx };
+	do
+	{
+		const Triangle& triangle{ m_Triangles[triangleIdx] };
+		int corner{};
+		while (triangle.vertices[corner] != vertex)
+			++corner;
+
+		m_Cavity.emplace_back(triangleIdx);
+		m_Boundary.emplace_back(BoundaryEdge{ triangle.vertices[(corner + 1) % 3], triangle.vertices[(corner + 2) % 3], triangle.neighbours[corner] });
+
+		//The next triangle counter clockwise shares the edge from the vertex to the end of this boundary edge
+		triangleIdx = triangle.neighbours[(corner + 1) % 3];
+	} while (triangleIdx != firstTriangleIdx);
+}
+
+void DelaunayMesh::FillStar()
+{
+	for (const int triangleIdx : m_Cavity)
+		FreeTriangle(triangleIdx);
+
+	//Cut ears off of the counter clockwise polygon in m_Boundary. An ear whose circum circle holds none of the other
+	//corners is a Delaunay triangle, and the polygon around a removed point always has one.
+	//Every ear becomes the outside triangle of the edge that closes the polygon behind it
+	auto LinkOutside = [this](int triangleIdx, int corner, const BoundaryEdge& edge)
+	{
+		m_Triangles[triangleIdx].neighbours[corner] = edge.outsideTriangle;
+		if (edge.outsideTriangle != -1)
+			ReplaceNeighbour(edge.outsideTriangle, edge.vertexA, edge.vertexB, triangleIdx);
+	};
+
+	while (m_Boundary.size() > 3)
+	{
+		const int numOfEdges{ int(m_Boundary.size()) };
+		int earIdx{ -1 }, convexIdx{ -1 };
+		for (int edgeIdx{}; edgeIdx < numOfEdges && earIdx == -1; ++edgeIdx)
+		{
+			const int vertexA{ m_Boundary[edgeIdx].vertexA };
+			const int vertexB{ m_Boundary[edgeIdx].vertexB };
+			const int vertexC{ m_Boundary[(edgeIdx + 1) % numOfEdges].vertexB };
+			if (Orientation(vertexA, vertexB, m_PointsX[vertexC], m_PointsY[vertexC]) <= 0.0) continue;
+			if (convexIdx == -1) convexIdx = edgeIdx;
+
+			bool isEmpty{ true };
+			for (int otherIdx{}; otherIdx < numOfEdges && isEmpty; ++otherIdx)
+			{
+				const int other{ m_Boundary[otherIdx].vertexA };
+				if (other == vertexA || other == vertexB || other == vertexC) continue;
+
+				isEmpty = utils::InCircleWithTies(m_PointsX[vertexA], m_PointsY[vertexA], m_PointsX[vertexB], m_PointsY[vertexB],
+					m_PointsX[vertexC], m_PointsY[vertexC], m_PointsX[other], m_PointsY[other]) <= 0.0;
+			}
+			if (isEmpty) earIdx = edgeIdx;
+		}
+		//Only a safety net that makes sure the loop ends, a polygon always has a convex corner
+		if (earIdx == -1) earIdx = convexIdx;
+
+		const int nextIdx{ (earIdx + 1) % numOfEdges };
+		const BoundaryEdge first{ m_Boundary[earIdx] };
+		const BoundaryEdge second{ m_Boundary[nextIdx] };
+
+		const int triangleIdx{ CreateTriangle(first.vertexA, first.vertexB, second.vertexB) };
+		LinkOutside(triangleIdx, 0, second);
+		LinkOutside(triangleIdx, 2, first);
+
+		m_Boundary[earIdx] = BoundaryEdge{ first.vertexA, second.vertexB, triangleIdx };
+		m_Boundary.erase(m_Boundary.begin() + nextIdx);
+	}
+
+	const int triangleIdx{ CreateTriangle(m_Boundary[0].vertexA, m_Boundary[1].vertexA, m_Boundary[2].vertexA) };
+	LinkOutside(triangleIdx, 0, m_Boundary[1]);
+	LinkOutside(triangleIdx, 1, m_Boundary[2]);
+	LinkOutside(triangleIdx, 2, m_Boundary[0]);
+	m_LastTriangle = triangleIdx;
+}
+
+void DelaunayMesh::FlipUntilDelaunay()
+{
+	while (!m_EdgesToCheck.empty())
+	{
+		const TriangleEdge edge{ m_EdgesToCheck.back() };
+		m_EdgesToCheck.pop_back();
+
+		//A flip of one of the other edges of the triangle can have taken this one away already
+		const Triangle& triangle{ m_Triangles[edge.triangleIdx] };
+		int corner{ -1 };
+		for (int i{}; i < 3; ++i)
+		{
+			if (triangle.vertices[(i + 1) % 3] == edge.vertexA && triangle.vertices[(i + 2) % 3] == edge.vertexB)
+				corner = i;
+		}
+		if (corner == -1) continue;
+
+		const int neighbour{ triangle.neighbours[corner] };
+		if (neighbour == -1) continue;
+
+		const Triangle& other{ m_Triangles[neighbour] };
+		int neighbourCorner{};
+		while (other.vertices[neighbourCorner] == edge.vertexA || other.vertices[neighbourCorner] == edge.vertexB)
+			++neighbourCorner;
+
+		const int opposite{ other.vertices[neighbourCorner] };
+		if (IsInCircumCircle(edge.triangleIdx, m_PointsX[opposite], m_PointsY[opposite]))
+			Flip(edge.triangleIdx, corner, neighbour, neighbourCorner);
+	}
+}
+
+void DelaunayMesh::Flip(int triangleIdx, int corner, int neighbour, int neighbourCorner)
+{
+	//(c, a, b) and (d, b, a) share a->b, they become (c, a, d) and (c, d, b) which share c->d.
+	//An edge that is not Delaunay always has a convex quad around it, so both new triangles are counter clockwise
+	const Triangle& triangle{ m_Triangles[triangleIdx] };
+	const Triangle& other{ m_Triangles[neighbour] };
+	const int c{ triangle.vertices[corner] };
+	const int a{ triangle.vertices[(corner + 1) % 3] };
+	const int b{ triangle.vertices[(corner + 2) % 3] };
+	const int d{ other.vertices[neighbourCorner] };
+
+	const int outsideBC{ triangle.neighbours[(corner + 1) % 3] };
+	const int outsideCA{ triangle.neighbours[(corner + 2) % 3] };
+	const int outsideAD{ other.neighbours[(neighbourCorner + 1) % 3] };
+	const int outsideDB{ other.neighbours[(neighbourCorner + 2) % 3] };
+
+	if (m_IsTrackingEdgeChanges)
+	{
+		TrackTriangle(triangleIdx, false);
+		TrackTriangle(neighbour, false);
+	}
+	SetTriangle(triangleIdx, c, a, d);
+	SetTriangle(neighbour, c, d, b);
+
+	Triangle& first{ m_Triangles[triangleIdx] };
+	first.neighbours[0] = outsideAD;
+	first.neighbours[1] = neighbour;
+	first.neighbours[2] = outsideCA;
+
+	Triangle& second{ m_Triangles[neighbour] };
+	second.neighbours[0] = outsideDB;
+	second.neighbours[1] = outsideBC;
+	second.neighbours[2] = triangleIdx;
+
+	if (outsideAD != -1) ReplaceNeighbour(outsideAD, a, d, triangleIdx);
+	if (outsideBC != -1) ReplaceNeighbour(outsideBC, b, c, neighbour);
+
+	//The four outside edges can have stopped being Delaunay
+	m_EdgesToCheck.emplace_back(TriangleEdge{ triangleIdx, a, d });
+	m_EdgesToCheck.emplace_back(TriangleEdge{ triangleIdx, c, a });
+	m_EdgesToCheck.emplace_back(TriangleEdge{ neighbour, d, b });
+	m_EdgesToCheck.emplace_back(TriangleEdge{ neighbour, b, c });
+}
+
+int DelaunayMesh::AddVertex(double x, double y)
+{
+	m_PointsX.emplace_back(x);
+	m_PointsY.emplace_back(y);
+	m_TriangleByVertex.emplace_back(-1);
+	return int(m_PointsX.size()) - 1;
+}
+
+void DelaunayMesh::GetSuperTriangle(double minX, double minY, double maxX, double maxY, double(&xs)[3], double(&ys)[3])
+{
+	//Far away from the points so that it hardly ever bends the hull of the real points
+	double size{ m_MinSuperTriangleSize };
+	while (std::max({ -minX, -minY, maxX, maxY }) > size / 4.0)
+		size *= 2.0;
+
+	xs[0] = -2.0 * size;
+	ys[0] = -size;
+	xs[1] = 2.0 * size;
+	ys[1] = -size;
+	xs[2] = 0.0;
+	ys[2] = 2.0 * size;
+}
+
+void DelaunayMesh::SetSuperTriangle(double minX, double minY, double maxX, double maxY)
+{
+	double xs[m_NumOfSuperVertices]{}, ys[m_NumOfSuperVertices]{};
+	GetSuperTriangle(minX, minY, maxX, maxY, xs, ys);
+	for (int vertex{}; vertex < m_NumOfSuperVertices; ++vertex)
+	{
+		m_PointsX[vertex] = xs[vertex];
+		m_PointsY[vertex] = ys[vertex];
+	}
+	m_LastTriangle = CreateTriangle(0, 1, 2);
+}
+
+void DelaunayMesh::GrowSuperTriangle(double x, double y)
+{
+	//Starts over with a super triangle around every point and the new one, the points go back in with the same indices
+	double minX{ x }, minY{ y }, maxX{ x }, maxY{ y };
+	for (int vertex{ m_NumOfSuperVertices }; vertex < int(m_PointsX.size()); ++vertex)
+	{
+		if (!IsPoint(vertex)) continue;
+
+		minX = std::min(minX, m_PointsX[vertex]);
+		minY = std::min(minY, m_PointsY[vertex]);
+		maxX = std::max(maxX, m_PointsX[vertex]);
+		maxY = std::max(maxY, m_PointsY[vertex]);
+	}
+
+	if (m_IsTrackingEdgeChanges)
+	{
+		for (int triangleIdx{}; triangleIdx < int(m_Triangles.size()); ++triangleIdx)
+		{
+			if (m_Triangles[triangleIdx].IsAlive()) TrackTriangle(triangleIdx, false);
+		}
+	}
+
+	m_Triangles.clear();
+	m_FreeTriangles.clear();
+	m_TriangleStamps.clear();
+	m_CurrentStamp = 0;
+	SetSuperTriangle(minX, minY, maxX, maxY);
+
+	for (int vertex{ m_NumOfSuperVertices }; vertex < int(m_PointsX.size()); ++vertex)
+	{
+		if (IsPoint(vertex) && FindCavity(m_PointsX[vertex], m_PointsY[vertex]))
+			FanCavity(vertex);
+	}
+}
+
+bool DelaunayMesh::IsInsideSuperTriangle(double x, double y) const
+{
+	return Orientation(0, 1, x, y) > 0.0 && Orientation(1, 2, x, y) > 0.0 && Orientation(2, 0, x, y) > 0.0;
+}
+
+int DelaunayMesh::CreateTriangle(int vertexA, int vertexB, int vertexC)
+{
+	int triangleIdx{};
+	if (!m_FreeTriangles.empty())
+	{
+		triangleIdx = m_FreeTriangles.back();
+		m_FreeTriangles.pop_back();
+	}
+	else
+	{
+		triangleIdx = int(m_Triangles.size());
+		m_Triangles.emplace_back();
+		m_TriangleStamps.emplace_back(0);
+	}
+
+	SetTriangle(triangleIdx, vertexA, vertexB, vertexC);
+	Triangle& triangle{ m_Triangles[triangleIdx] };
+	triangle.neighbours[0] = triangle.neighbours[1] = triangle.neighbours[2] = -1;
+	return triangleIdx;
+}
+
+void DelaunayMesh::SetTriangle(int triangleIdx, int vertexA, int vertexB, int vertexC)
+{
+	Triangle& triangle{ m_Triangles[triangleIdx] };
+	triangle.vertices[0] = vertexA;
+	triangle.vertices[1] = vertexB;
+	triangle.vertices[2] = vertexC;
+	m_TriangleByVertex[vertexA] = m_TriangleByVertex[vertexB] = m_TriangleByVertex[vertexC] = triangleIdx;
+	if (m_IsTrackingEdgeChanges) TrackTriangle(triangleIdx, true);
+}
+
+void DelaunayMesh::FreeTriangle(int triangleIdx)
+{
+	if (m_IsTrackingEdgeChanges) TrackTriangle(triangleIdx, false);
+	m_Triangles[triangleIdx].vertices[0] = -1;
+	m_FreeTriangles.emplace_back(triangleIdx);
+}
+
+void DelaunayMesh::TrackTriangle(int triangleIdx, bool isAdded)
+{
+	std::vector<uint64_t>& edgeKeys{ isAdded ? m_AddedEdgeKeys : m_RemovedEdgeKeys };
+	const Triangle& triangle{ m_Triangles[triangleIdx] };
+	for (int i{}; i < 3; ++i)
+	{
+		const int vertexA{ std::min(triangle.vertices[i], triangle.vertices[(i + 1) % 3]) };
+		const int vertexB{ std::max(triangle.vertices[i], triangle.vertices[(i + 1) % 3]) };
+		if (vertexA >= m_NumOfSuperVertices) edgeKeys.emplace_back((uint64_t(vertexA) << 32) | uint64_t(vertexB));
+	}
+
+	int lowest{};
+	for (int i{ 1 }; i < 3; ++i)
+	{
+		if (triangle.vertices[i] < triangle.vertices[lowest]) lowest = i;
+	}
+	if (triangle.vertices[lowest] < m_NumOfSuperVertices) return;
+
+	TriangleCorners corners{};
+	for (int i{}; i < 3; ++i)
+		corners.points[i] = triangle.vertices[(lowest + i) % 3] - m_NumOfSuperVertices;
+	(isAdded ? m_AddedTriangles : m_RemovedTriangles).emplace_back(corners);
+}
+
+int DelaunayMesh::Locate(double x, double y) const
+{
+	//Walk towards the point from the last triangle that was made, points next to each other usually end up close by
+	int triangleIdx{ m_LastTriangle };
+	const int maxSteps{ int(m_Triangles.size()) };
+
+	for (int step{}; step < maxSteps; ++step)
+	{
+		const Triangle& triangle{ m_Triangles[triangleIdx] };
+
+		int nextTriangleIdx{ triangleIdx };
+		for (int i{}; i < 3; ++i)
+		{
+			//Start from a different edge every step so the walk can not circle around
+			const int edge{ (i + step) % 3 };
+			if (Orientation(triangle.vertices[(edge + 1) % 3], triangle.vertices[(edge + 2) % 3], x, y) < 0.0)
+			{
+				nextTriangleIdx = triangle.neighbours[edge];
+				break;
+			}
+		}
+
+		if (nextTriangleIdx == triangleIdx) return triangleIdx;
+		if (nextTriangleIdx == -1) return -1;
+		triangleIdx = nextTriangleIdx;
+	}
+
+	//The walk got lost, fall back to checking every triangle with the same exact test the walk uses.
+	//Removed triangles have -1 as their first vertex and are skipped
+	for (int candidateIdx{}; candidateIdx < int(m_Triangles.size()); ++candidateIdx)
+	{
+		const Triangle& triangle{ m_Triangles[candidateIdx] };
+		if (!triangle.IsAlive()) continue;
+
+		bool isInside{ true };
+		for (int edge{}; edge < 3 && isInside; ++edge)
+			isInside = Orientation(triangle.vertices[(edge + 1) % 3], triangle.vertices[(edge + 2) % 3], x, y) >= 0.0;
+		if (isInside) return candidateIdx;
+	}
+	return -1;
+}
+
+double DelaunayMesh::Orientation(int vertexA, int vertexB, double x, double y) const
+{
+	//Positive when the point is on the left of a->b
+	return utils::Orient2d(m_PointsX[vertexA], m_PointsY[vertexA], m_PointsX[vertexB], m_PointsY[vertexB], x, y);
+}
+
+bool DelaunayMesh::IsInCircumCircle(int triangleIdx, double x, double y) const
+{
+	const Triangle& triangle{ m_Triangles[triangleIdx] };
+	const int vertexA{ triangle.vertices[0] }, vertexB{ triangle.vertices[1] }, vertexC{ triangle.vertices[2] };
+	return utils::InCircleWithTies(m_PointsX[vertexA], m_PointsY[vertexA], m_PointsX[vertexB], m_PointsY[vertexB],
+		m_PointsX[vertexC], m_PointsY[vertexC], x, y) > 0.0;
+}
+
+void DelaunayMesh::ReplaceNeighbour(int triangleIdx, int vertexA, int vertexB, int newNeighbour)
+{
+	Triangle& triangle{ m_Triangles[triangleIdx] };
+	for (int i{}; i < 3; ++i)
+	{
+		const int vertex{ triangle.vertices[i] };
+		if (vertex != vertexA && vertex != vertexB)
+		{
+			triangle.neighbours[i] = newNeighbour;
+			return;
+		}
+	}
+}
@@ -0,0 +1,213 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "InCircleKernel.h"
+
+//Triangle mesh for the Bowyer-Watson triangulation.
+//Every triangle knows its neighbours, so inserting a point only visits the triangles around that point
+//instead of the whole triangulation, and removing or moving a point only repairs the triangles around it.
+//Removed triangles go on a free list and get reused by the next insertion.
+class DelaunayMesh final
+{
+public:
+	struct Triangle
+	{
+		int vertices[3]; //Counter clockwise
+		int neighbours[3]; //neighbours[i] is across the edge opposite of vertices[i], -1 when there is none
+
+		bool IsAlive() const { return vertices[0] != -1; }
+	};
+
+	//The points of a triangle counter clockwise, starting at the lowest one
+	struct TriangleCorners
+	{
+		int points[3];
+
+		bool operator<(const TriangleCorners& other) const
+		{
+			for (int i{}; i < 3; ++i)
+			{
+				if (points[i] != other.points[i]) return points[i] < other.points[i];
+			}
+			return false;
+		}
+		bool operator==(const TriangleCorners& other) const
+		{
+			return points[0] == other.points[0] && points[1] == other.points[1] && points[2] == other.points[2];
+		}
+	};
+
+	DelaunayMesh() = default;
+
+	//Starts a new triangulation with a super triangle that surrounds the bounds
+	void Begin(float minX, float minY, float maxX, float maxY, int numOfPointsToReserve = 0);
+	//Corners of the super triangle for the bounds. It is centered on the origin and only grows in powers of two,
+	//so the same points always get the same super triangle no matter how they got into the mesh.
+	//The edges between the points then only depend on the points, cocircular points are settled by utils::InCircleWithTies
+	static void GetSuperTriangle(double minX, double minY, double maxX, double maxY, double(&xs)[3], double(&ys)[3]);
+	//Adds a point and returns its index, or -1 when it is a duplicate. The index of a removed point gets reused.
+	//A point outside of the super triangle makes the mesh start over with a bigger one, which is slow but rare.
+	int InsertPoint(float x, float y);
+	//Index of the point at exactly these coordinates, -1 when there is none
+	int FindPoint(float x, float y) const;
+	//Takes a point out and fills the hole it leaves behind, returns false when there is no such point
+	bool RemovePoint(int pointIdx);
+	//Moves a point and keeps its index. When the point stays inside of the triangles around it only those get repaired
+	//with edge flips, otherwise it gets removed and inserted again. Returns false when there is no such point or when
+	//it ended up on top of another one, it is then removed like a duplicate
+	bool MovePoint(int pointIdx, float x, float y);
+	//Keeps the allocated memory around for the next triangulation, and stops tracking edge changes
+	void Clear();
+
+	//While tracking, the mesh remembers which edges and triangles the insertions, removals and moves add and take away,
+	//so whatever is built on top of them only has to look at those
+	void SetTrackingEdgeChanges(bool isTracking);
+	//Fills in the edges that came and went since the last call as pairs of points and starts over.
+	//An edge that went away and came back is in neither. Edges that stayed but got longer or shorter are not in there either,
+	//those are the edges of a moved point
+	void TakeEdgeChanges(std::vector<std::pair<int, int>>& addedEdges, std::vector<std::pair<int, int>>& removedEdges);
+	//The same for the triangles between three inserted points, triangles with a corner of the super triangle are left out
+	void TakeTriangleChanges(std::vector<TriangleCorners>& addedTriangles, std::vector<TriangleCorners>& removedTriangles);
+
+	//Removed points still count until their index gets reused
+	int GetNumOfPoints() const { return int(m_PointsX.size()) - m_NumOfSuperVertices; }
+
+	//Calls function(pointA, pointB) once for every edge between two inserted points, edges to the super triangle are skipped
+	template<typename Function>
+	void ForEachEdge(Function function) const
+	{
+		for (int triangleIdx{}; triangleIdx < int(m_Triangles.size()); ++triangleIdx)
+		{
+			const Triangle& triangle{ m_Triangles[triangleIdx] };
+			if (!triangle.IsAlive()) continue;
+
+			for (int i{}; i < 3; ++i)
+			{
+				//Both triangles next to an edge see it, only the one with the lowest index reports it
+				const int neighbour{ triangle.neighbours[i] };
+				if (neighbour != -1 && neighbour < triangleIdx) continue;
+
+				const int vertexA{ triangle.vertices[(i + 1) % 3] };
+				const int vertexB{ triangle.vertices[(i + 2) % 3] };
+				if (vertexA < m_NumOfSuperVertices || vertexB < m_NumOfSuperVertices) continue;
+
+				function(vertexA - m_NumOfSuperVertices, vertexB - m_NumOfSuperVertices);
+			}
+		}
+	}
+
+	//Calls function(pointA, pointB, pointC) once for every triangle between three inserted points, with the points counter clockwise
+	template<typename Function>
+	void ForEachTriangle(Function function) const
+	{
+		for (const Triangle& triangle : m_Triangles)
+		{
+			if (!triangle.IsAlive()) continue;
+			if (triangle.vertices[0] < m_NumOfSuperVertices || triangle.vertices[1] < m_NumOfSuperVertices || triangle.vertices[2] < m_NumOfSuperVertices) continue;
+
+			function(triangle.vertices[0] - m_NumOfSuperVertices, triangle.vertices[1] - m_NumOfSuperVertices, triangle.vertices[2] - m_NumOfSuperVertices);
+		}
+	}
+
+	//Calls function(otherPoint) for every point that shares an edge with the point
+	template<typename Function>
+	void ForEachNeighbour(int pointIdx, Function function) const
+	{
+		const int vertex{ pointIdx + m_NumOfSuperVertices };
+		if (!IsPoint(vertex)) return;
+
+		//Walks around the vertex like CollectStar, every triangle gives the vertex after it
+		const int firstTriangleIdx{ FindTriangleWithVertex(vertex) };
+		int triangleIdx{ firstTriangleIdx };
+		do
+		{
+			const Triangle& triangle{ m_Triangles[triangleIdx] };
+			int corner{};
+			while (triangle.vertices[corner] != vertex)
+				++corner;
+
+			const int other{ triangle.vertices[(corner + 1) % 3] };
+			if (other >= m_NumOfSuperVertices) function(other - m_NumOfSuperVertices);
+
+			triangleIdx = triangle.neighbours[(corner + 1) % 3];
+		} while (triangleIdx != firstTriangleIdx && triangleIdx != -1);
+	}
+
+private:
+	static constexpr int m_NumOfSuperVertices{ 3 };
+	static constexpr double m_MinSuperTriangleSize{ 1073741824.0 }; //2^30
+
+	//The super triangle takes the first three vertices, removed points are NaN
+	std::vector<double> m_PointsX{};
+	std::vector<double> m_PointsY{};
+	std::vector<int> m_TriangleByVertex{}; //One of the triangles of every vertex, so a removal or a move does not have to search
+	std::vector<int> m_FreeVertices{};
+
+	std::vector<Triangle> m_Triangles{};
+	std::vector<int> m_FreeTriangles{};
+	int m_LastTriangle{ -1 };
+
+	struct BoundaryEdge
+	{
+		int vertexA;
+		int vertexB;
+		int outsideTriangle;
+	};
+
+	//An edge going from vertexA to vertexB counter clockwise around the triangle
+	struct TriangleEdge
+	{
+		int triangleIdx;
+		int vertexA;
+		int vertexB;
+	};
+
+	//Scratch buffers for an insertion, a removal or a move
+	std::vector<int> m_TriangleStamps{};
+	int m_CurrentStamp{};
+	std::vector<int> m_Stack{};
+	std::vector<int> m_Cavity{};
+	std::vector<BoundaryEdge> m_Boundary{};
+	std::vector<BoundaryEdge> m_CavityEdges{}; //Edges of the newest ring of the cavity that still have to be tested
+	utils::CircleBatch m_CircleBatch{};
+	std::vector<int> m_NewTriangleByStart{};
+	std::vector<TriangleEdge> m_EdgesToCheck{};
+
+	//Both triangles next to an edge add it to these, so an edge that stayed is in both the same number of times.
+	//The keys are the two vertices, lowest first. The triangles themselves go in the same way
+	bool m_IsTrackingEdgeChanges{ false };
+	std::vector<uint64_t> m_AddedEdgeKeys{};
+	std::vector<uint64_t> m_RemovedEdgeKeys{};
+	std::vector<TriangleCorners> m_AddedTriangles{};
+	std::vector<TriangleCorners> m_RemovedTriangles{};
+
+	int AddVertex(double x, double y);
+	void SetSuperTriangle(double minX, double minY, double maxX, double maxY);
+	void GrowSuperTriangle(double x, double y);
+	bool IsInsideSuperTriangle(double x, double y) const;
+	int CreateTriangle(int vertexA, int vertexB, int vertexC);
+	void SetTriangle(int triangleIdx, int vertexA, int vertexB, int vertexC);
+	void FreeTriangle(int triangleIdx);
+	void TrackTriangle(int triangleIdx, bool isAdded);
+
+	//Insertion: the cavity is every triangle whose circum circle holds the point, its boundary gets fanned around the point
+	bool InsertVertex(int vertex, double x, double y);
+	bool FindCavity(double x, double y);
+	void FanCavity(int vertex);
+
+	//Removal: the triangles around a vertex go in the cavity and the polygon around them in the boundary
+	bool IsPoint(int vertex) const;
+	int FindTriangleWithVertex(int vertex) const;
+	void CollectStar(int vertex, int triangleIdx);
+	void FillStar();
+
+	void FlipUntilDelaunay();
+	void Flip(int triangleIdx, int corner, int neighbour, int neighbourCorner);
+
+	int Locate(double x, double y) const;
+	double Orientation(int vertexA, int vertexB, double x, double y) const;
+	bool IsInCircumCircle(int triangleIdx, double x, double y) const;
+	void ReplaceNeighbour(int triangleIdx, int vertexA, int vertexB, int newNeighbour);
+};
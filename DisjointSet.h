@@ -0,0 +1,58 @@
+#pragma once
+#include <numeric>
+#include <vector>
+
+//Keeps track of which elements are in the same set, used to find the minimum spanning tree.
+//Both finding and joining are close to constant time thanks to path compression and union by rank.
+class DisjointSet final
+{
+public:
+	DisjointSet() = default;
+	explicit DisjointSet(int numOfElements)
+	{
+		Reset(numOfElements);
+	}
+
+	//Puts every element in a set of its own
+	void Reset(int numOfElements)
+	{
+		m_Parents.resize(numOfElements);
+		std::iota(m_Parents.begin(), m_Parents.end(), 0);
+		m_Ranks.assign(numOfElements, 0);
+	}
+
+	int Find(int element)
+	{
+		int root{ element };
+		while (m_Parents[root] != root)
+			root = m_Parents[root];
+
+		//Point everything on the way straight to the root
+		while (m_Parents[element] != root)
+		{
+			const int parent{ m_Parents[element] };
+			m_Parents[element] = root;
+			element = parent;
+		}
+		return root;
+	}
+
+	//Returns false when both elements were already in the same set
+	bool Unite(int elementA, int elementB)
+	{
+		int rootA{ Find(elementA) };
+		int rootB{ Find(elementB) };
+		if (rootA == rootB) return false;
+
+		//Hang the shallower tree under the deeper one
+		if (m_Ranks[rootA] < m_Ranks[rootB]) std::swap(rootA, rootB);
+		m_Parents[rootB] = rootA;
+		if (m_Ranks[rootA] == m_Ranks[rootB]) ++m_Ranks[rootA];
+
+		return true;
+	}
+
+private:
+	std::vector<int> m_Parents{};
+	std::vector<int> m_Ranks{};
+};
@@ -0,0 +1,470 @@
+#include "DungeonGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "ThreadPool.h"
+
+void DungeonResult::Clear()
+{
+	rooms.Clear();
+	hallways.clear();
+	separationIterations = 0;
+	isSeparated = false;
+	delaunayEdges.clear();
+	mstEdges.clear();
+	deletedEdges.clear();
+	roomConnections.clear();
+}
+
+DungeonGenerator::DungeonGenerator(const DungeonParams& params)
+{
+	Reset(params);
+}
+
+DungeonGenerator::~DungeonGenerator()
+{
+	delete m_pTriangulationPool;
+}
+
+void DungeonGenerator::Reset(const DungeonParams& params)
+{
+	m_Rooms.Clear();
+	m_Hallways.clear();
+	m_AddedBackRooms.clear();
+	m_BossRoomIdx = -1;
+	m_IsEdited = false;
+	m_AreHallwaysDynamic = false;
+	m_Graph.Reset();
+	m_Result.Clear();
+
+	m_Params = params;
+	if (m_Params.numOfRoomsToGen <= 0) m_Params.numOfRoomsToGen = m_Params.minimumNumOfRooms * 2;
+
+	for (auto& seconds : m_StageSeconds)
+		seconds = 0.0;
+	m_SeparationIterations = 0;
+	m_IsSeparated = false;
+	m_SeparationState = SeparationState{};
+
+	//Initialize all the rooms and add them to the store
+	Pcg32 random{ CreateRandom(roomSeparation) };
+	Room::SpawnRooms(m_Rooms, m_Params.numOfRoomsToGen, m_Params.spawnWidth, m_Params.spawnHeight, random);
+
+	//Rooms that are close together in space are close together in memory, which keeps the separation's neighbour lookups local
+	m_Rooms.SortAlongHilbertCurve();
+
+	SetStage(roomSeparation);
+}
+
+DungeonGenerator::Stage DungeonGenerator::Step()
+{
+	if (m_CurrentStage == done) return m_CurrentStage;
+
+	const Stage stage{ m_CurrentStage };
+	const auto startTime{ std::chrono::steady_clock::now() };
+
+	switch (m_CurrentStage)
+	{
+		//Step 1: Separate the rooms
+	case roomSeparation:
+	{
+		float tightnessChecked{ m_Params.roomTightness };
+		if (tightnessChecked < 1.f) tightnessChecked = 1;
+		if (tightnessChecked > 3.f) tightnessChecked = 3;
+
+		if (m_Params.solveSeparation)
+		{
+			//A solver iteration is split up over steps by rooms, checking the result gets steps of its own since it goes over every room again.
+			//m_StageProgress is 0 while solving, 1 when the check starts and after that two past the next room to check
+			if (m_StageProgress == 0)
+			{
+				bool hasMovedRooms{};
+				if (m_SeparationIterations >= m_Params.maxSeparationIterations)
+					m_StageProgress = 1;
+				else if (Room::ContinueSeparationStep(m_Rooms, tightnessChecked, m_SeparationState, m_RoomGrid, m_RoomsPerSeparationStep, hasMovedRooms))
+				{
+					if (hasMovedRooms) ++m_SeparationIterations;
+					else m_StageProgress = 1;
+				}
+				break;
+			}
+
+			if (m_StageProgress == 1)
+			{
+				Room::BeginOverlapCheck(m_Rooms, m_RoomGrid);
+				++m_StageProgress;
+				break;
+			}
+
+			const int firstRoom{ m_StageProgress - 2 };
+			const int endRoom{ std::min(m_Rooms.GetSize(), firstRoom + m_RoomsPerSeparationStep) };
+			m_IsSeparated = !Room::AreRoomsOverlapping(m_Rooms, m_RoomGrid, firstRoom, endRoom);
+			m_StageProgress += endRoom - firstRoom;
+			//Move on even when the cap was hit, so a dungeon never takes longer than the cap
+			if (!m_IsSeparated || endRoom == m_Rooms.GetSize())
+				SetStage(roomDeletion);
+			break;
+		}
+
+		//A whole push per step, this one is meant to be watched
+		Room::SeparateRooms(m_Rooms, tightnessChecked, m_RoomGrid);
+		++m_SeparationIterations;
+
+		if (!Room::AreRoomsOverlapping(m_Rooms, m_RoomGrid))
+		{
+			m_IsSeparated = true;
+			SetStage(roomDeletion);
+		}
+	}
+	break;
+	//Step 2: Delete all the secondary rooms
+	case roomDeletion:
+		//Every part goes over all of the rooms, so they each get a step
+		if (m_StageProgress == 0)
+		{
+			//The biggest rooms get deleted
+			m_Rooms.KeepSmallest(m_Params.minimumNumOfRooms);
+			++m_StageProgress;
+			break;
+		}
+		if (m_StageProgress == 1)
+		{
+			//The separation moved the rooms around, put them back in curve order for everything after it.
+			//This is a sort, it cannot be split up
+			m_Rooms.SortAlongHilbertCurve();
+			++m_StageProgress;
+			break;
+		}
+
+		//The graph refers to the rooms by their index in the store
+		m_GraphPoints.clear();
+		for (int roomIdx{}; roomIdx < m_Rooms.GetSize(); ++roomIdx)
+		{
+			if (m_Rooms.IsAlive(roomIdx))
+				m_GraphPoints.emplace_back(m_Rooms.GetCenter(roomIdx), roomIdx);
+		}
+
+		m_Graph.SetPoints(m_GraphPoints);
+		SetStage(delaunyTriangulation);
+		break;
+	//Step 3: Calculate the Delauny Triangulation, a batch of points per step
+	case delaunyTriangulation:
+		if (m_Params.triangulationThreads > 1 && int(m_GraphPoints.size()) >= m_MinPointsForParallelTriangulation)
+		{
+			if (!m_pTriangulationPool || m_pTriangulationPool->GetNumOfThreads() != m_Params.triangulationThreads)
+			{
+				delete m_pTriangulationPool;
+				m_pTriangulationPool = new ThreadPool(m_Params.triangulationThreads);
+			}
+			m_Graph.CalculateTriangulationParallel(*m_pTriangulationPool);
+			SetStage(MST);
+			break;
+		}
+
+		if (m_StageProgress++ == 0)
+			m_Graph.BeginTriangulation();
+		if (m_Graph.ContinueTriangulation(m_PointsPerStep))
+			SetStage(MST);
+		break;
+		//Step 4: Find the minimum spanning tree for the triangulation
+	case MST:
+		//Sorting the edges is the first step, after that Kruskal goes over a batch of them per step
+		if (m_StageProgress++ == 0)
+		{
+			m_Graph.BeginMST();
+			break;
+		}
+		if (m_Graph.ContinueMST(m_EdgesPerStep))
+			SetStage(roomConnections);
+		break;
+		//Step 5: Randomly add deleted edges to add variation and cycles to the dungeon
+	case roomConnections:
+	{
+		Pcg32 random{ CreateRandom(roomConnections) };
+		m_Graph.FillRoomConnections(random);
+	}
+		SetStage(addingHallways);
+		break;
+		//Step 6: Connect the rooms based on the room connections formed from the previous steps
+	case addingHallways:
+		if (CreateHallways())
+			SetStage(addDeletedRooms);
+		break;
+		//Step 7: Bring back the deleted rooms that the hallways go through
+	case addDeletedRooms:
+		if (AddDeletedRooms())
+		{
+			FillResult();
+			SetStage(done);
+		}
+		break;
+	case done:
+		break;
+	}
+
+	m_StageSeconds[stage] += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	return m_CurrentStage;
+}
+
+bool DungeonGenerator::Advance(double budgetMs)
+{
+	const auto startTime{ std::chrono::steady_clock::now() };
+	do
+	{
+		Step();
+	} while (m_CurrentStage != done && std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count() < budgetMs);
+
+	return m_CurrentStage == done;
+}
+
+const DungeonResult& DungeonGenerator::Generate()
+{
+	while (m_CurrentStage != done)
+		Step();
+
+	return m_Result;
+}
+
+void DungeonGenerator::SetMinimumNumOfRooms(int minimumNumOfRooms)
+{
+	m_Params.minimumNumOfRooms = minimumNumOfRooms;
+	if (m_CurrentStage <= roomDeletion) return;
+
+	RestoreGraphRooms();
+
+	//The same rooms KeepSmallest would keep, a room at a time
+	while (int(m_Graph.GetPoints().size()) < minimumNumOfRooms)
+	{
+		const int roomIdx{ m_Rooms.FindSmallestDeadRoom() };
+		if (roomIdx == -1) break;
+
+		BeginRoomEdit(roomIdx);
+		m_Rooms.SetAlive(roomIdx, true);
+		m_Graph.InsertPoint(Vertex{ m_Rooms.GetCenter(roomIdx), roomIdx });
+	}
+	while (int(m_Graph.GetPoints().size()) > std::max(minimumNumOfRooms, 0))
+	{
+		const int roomIdx{ m_Rooms.FindBiggestAliveRoom() };
+		BeginRoomEdit(roomIdx);
+		m_Rooms.SetAlive(roomIdx, false);
+		m_Graph.RemovePoint(m_Graph.FindPoint(roomIdx));
+	}
+
+	SetStage(MST);
+}
+
+void DungeonGenerator::MoveRoom(int roomIdx, float x, float y)
+{
+	if (roomIdx < 0 || roomIdx >= m_Rooms.GetSize()) return;
+	if (m_CurrentStage <= roomDeletion)
+	{
+		m_Rooms.Move(roomIdx, x, y);
+		return;
+	}
+
+	RestoreGraphRooms();
+	BeginRoomEdit(roomIdx);
+	m_Rooms.Move(roomIdx, x, y);
+
+	//Deleted rooms have no point, but they can still be in the way of the hallways
+	const int pointIdx{ m_Graph.FindPoint(roomIdx) };
+	if (pointIdx != -1)
+	{
+		const Point2f center{ m_Rooms.GetCenter(roomIdx) };
+		m_Graph.MovePoint(pointIdx, center.x, center.y);
+	}
+
+	SetStage(MST);
+}
+
+Pcg32 DungeonGenerator::CreateRandom(Stage stage) const
+{
+	//Every stage gets its own stream, so changing how much one stage uses it does not change the others
+	return Pcg32{ m_Params.seed, uint64_t(stage) };
+}
+
+const char* DungeonGenerator::GetStageName(Stage stage)
+{
+	switch (stage)
+	{
+	case roomSeparation: return "Room Separation";
+	case roomDeletion: return "Room Deletion";
+	case delaunyTriangulation: return "Delauny Triangulation";
+	case MST: return "MST";
+	case roomConnections: return "Room Connections";
+	case addingHallways: return "Adding Hallways";
+	case addDeletedRooms: return "Add Deleted Rooms";
+	case done: return "Done";
+	}
+	return "Unknown";
+}
+
+void DungeonGenerator::SetStage(Stage stage)
+{
+	m_CurrentStage = stage;
+	m_StageProgress = 0;
+	m_IsRouterStarted = false;
+}
+
+bool DungeonGenerator::CreateHallways()
+{
+	if (m_IsEdited) return CreateEditedHallways();
+
+	//Putting the rooms in the router's grid takes steps of its own, m_StageProgress stays 0 until that is done
+	if (m_StageProgress == 0)
+	{
+		if (!m_IsRouterStarted)
+		{
+			if (m_Params.routeHallways)
+				m_HallwayRouter.BeginGrid(m_Rooms);
+			m_HallwayRandom = CreateRandom(addingHallways);
+			m_IsRouterStarted = true;
+			return false;
+		}
+		if (m_Params.routeHallways && !m_HallwayRouter.ContinueGrid(m_Rooms, m_CellsPerStep))
+			return false;
+
+		++m_StageProgress;
+		return false;
+	}
+
+	//After that m_StageProgress is one past the next connection to make a hallway for
+	const std::vector<Connection>& connections{ m_Graph.GetRoomConnections() };
+	const int endConnection{ std::min(int(connections.size()), m_StageProgress - 1 + m_ConnectionsPerStep) };
+	for (; m_StageProgress - 1 < endConnection; ++m_StageProgress)
+	{
+		const int from{ connections[m_StageProgress - 1].start.roomConnectionID };
+		const int to{ connections[m_StageProgress - 1].end.roomConnectionID };
+
+		//Rooms that are walled in by other rooms still get the straight hallways
+		if (!m_Params.routeHallways || !m_HallwayRouter.Route(m_Rooms, from, to, m_Hallways))
+			Room::ConnectRooms(m_Rooms, from, to, m_Hallways, m_HallwayRandom);
+	}
+	return m_StageProgress - 1 == int(connections.size());
+}
+
+bool DungeonGenerator::CreateEditedHallways()
+{
+	HallwayRouter* pRouter{ m_Params.routeHallways ? &m_HallwayRouter : nullptr };
+
+	//The first time the grid gets made again and every connection gets routed, so the hallways of every connection are known
+	if (!m_AreHallwaysDynamic)
+	{
+		if (!m_IsRouterStarted)
+		{
+			if (pRouter) m_HallwayRouter.BeginGrid(m_Rooms);
+			m_HallwayRandom = CreateRandom(addingHallways);
+			m_IsRouterStarted = true;
+			return false;
+		}
+		if (pRouter && !m_HallwayRouter.ContinueGrid(m_Rooms, m_CellsPerStep))
+			return false;
+
+		//The changes are all in the connections already
+		m_Graph.TakeConnectionChanges(m_ConnectionChanges);
+		m_DynamicHallways.Begin(m_Rooms);
+		for (const auto& connection : m_Graph.GetRoomConnections())
+			m_DynamicHallways.AddConnection(connection.start.roomConnectionID, connection.end.roomConnectionID);
+		m_AreHallwaysDynamic = true;
+		return false;
+	}
+
+	//After that m_StageProgress is 0 until the edits are applied
+	if (m_StageProgress == 0)
+	{
+		m_Graph.TakeConnectionChanges(m_ConnectionChanges);
+		if (!m_DynamicHallways.ApplyEdits(m_Rooms, m_ConnectionChanges, pRouter))
+		{
+			//A room moved off the grid, make it again
+			m_AreHallwaysDynamic = false;
+			m_IsRouterStarted = false;
+			return false;
+		}
+		++m_StageProgress;
+		return false;
+	}
+	return m_DynamicHallways.ContinueRouting(m_Rooms, pRouter, m_ConnectionsPerStep, m_HallwayRandom);
+}
+
+bool DungeonGenerator::AddDeletedRooms()
+{
+	if (m_AreHallwaysDynamic)
+	{
+		//The hallways counted the rooms they go through, the rooms that are not in the graph come back
+		m_DynamicHallways.GetHallways(m_Hallways);
+		m_DynamicHallways.GetCrossedRooms(m_CrossedRooms);
+		for (const int roomIdx : m_CrossedRooms)
+		{
+			if (m_Rooms.IsAlive(roomIdx)) continue;
+
+			m_Rooms.SetAlive(roomIdx, true);
+			m_AddedBackRooms.emplace_back(roomIdx);
+		}
+		m_StageProgress = m_Rooms.GetSize();
+	}
+
+	//m_StageProgress is the next room to check
+	const int endRoom{ std::min(m_Rooms.GetSize(), m_StageProgress + m_RoomsPerStep) };
+	for (; m_StageProgress < endRoom; ++m_StageProgress)
+	{
+		const int roomIdx{ m_StageProgress };
+		if (m_Rooms.IsAlive(roomIdx)) continue;
+
+		const Rectf rect{ m_Rooms.GetRect(roomIdx) };
+		float minFlt{}, maxFlt{};
+		for (const auto& hallway : m_Hallways)
+		{
+			if (utils::IntersectRectLine(rect, hallway.startingPoint, hallway.endPoint, minFlt, maxFlt))
+			{
+				m_Rooms.SetAlive(roomIdx, true);
+				m_AddedBackRooms.emplace_back(roomIdx);
+				break;
+			}
+		}
+	}
+	if (m_StageProgress < m_Rooms.GetSize()) return false;
+
+	//Add any special rooms here:
+	//The biggest room is the boss room
+	m_BossRoomIdx = m_Rooms.FindBiggestAliveRoom();
+	if (m_BossRoomIdx != -1)
+		m_Rooms.SetType(m_BossRoomIdx, RoomStore::BOSS);
+
+	return true;
+}
+
+void DungeonGenerator::RestoreGraphRooms()
+{
+	//The rooms in the graph are exactly the alive rooms before addingRooms, every edit keeps the two the same
+	for (const int roomIdx : m_AddedBackRooms)
+		m_Rooms.SetAlive(roomIdx, false);
+	m_AddedBackRooms.clear();
+
+	if (m_BossRoomIdx != -1)
+		m_Rooms.SetType(m_BossRoomIdx, RoomStore::DEFAULT);
+	m_BossRoomIdx = -1;
+
+	m_Hallways.clear();
+}
+
+void DungeonGenerator::BeginRoomEdit(int roomIdx)
+{
+	m_IsEdited = true;
+	if (m_AreHallwaysDynamic) m_DynamicHallways.BeginRoomEdit(m_Rooms, roomIdx);
+}
+
+void DungeonGenerator::FillResult()
+{
+	m_Result.Clear();
+
+	m_Result.rooms = m_Rooms;
+
+	m_Result.hallways = m_Hallways;
+	m_Result.separationIterations = m_SeparationIterations;
+	m_Result.isSeparated = m_IsSeparated;
+	m_Result.delaunayEdges = m_Graph.GetEdges();
+	m_Result.mstEdges = m_Graph.GetMSTEdges();
+	m_Result.deletedEdges = m_Graph.GetDeletedEdges();
+	m_Result.roomConnections = m_Graph.GetRoomConnections();
+}
@@ -0,0 +1,171 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Room.h"
+#include "Graph.h"
+#include "HallwayRouter.h"
+#include "DynamicHallways.h"
+
+class ThreadPool;
+
+//Everything the generator needs to know to build a dungeon
+struct DungeonParams
+{
+	int minimumNumOfRooms{ 10 };
+	int numOfRoomsToGen{ 0 }; //0 means twice the minimum number of rooms
+	float roomTightness{ 1.f }; //[1,3]
+	unsigned int seed{ 0 }; //The same seed and parameters give the same dungeon
+
+	//Solve the room separation in one step instead of doing one push per step, the push per step version is nice to watch
+	bool solveSeparation{ true };
+	int maxSeparationIterations{ 2000 }; //The solver moves on with whatever it has after this many iterations
+
+	//Threads for the triangulation, more than 1 uses the parallel divide and conquer triangulation for big dungeons.
+	//It makes the same triangulation, so the dungeon stays the same. It runs in a single step, so it does not spread out over Advance calls
+	int triangulationThreads{ 1 };
+
+	//Route the hallways around the rooms with A* and merge them into corridors, false gives the straight L-shaped hallways
+	bool routeHallways{ true };
+
+	//Area the rooms spawn in before they get separated
+	float spawnWidth{ 846.f };
+	float spawnHeight{ 500.f };
+
+	//Grows the spawn area with the number of rooms so big dungeons don't start out as one pile
+	void ScaleSpawnArea()
+	{
+		const float areaScale{ std::max(1.f, std::sqrt(float(minimumNumOfRooms) / 10.f)) };
+		spawnWidth *= areaScale;
+		spawnHeight *= areaScale;
+	}
+};
+
+//Plain data describing a finished dungeon, nothing in here needs a window to be used
+struct DungeonResult
+{
+	RoomStore rooms{}; //Rooms that are not alive were deleted and no hallway goes through them
+	std::vector<Hallway> hallways{};
+
+	int separationIterations{};
+	bool isSeparated{}; //False when the separation solver hit its iteration cap
+
+	//Graph data, only used for debugging
+	std::vector<Connection> delaunayEdges{};
+	std::vector<Connection> mstEdges{};
+	std::vector<Connection> deletedEdges{};
+	std::vector<Connection> roomConnections{};
+
+	void Clear();
+};
+
+class DungeonGenerator final
+{
+public:
+	enum Stage
+	{
+		roomSeparation,
+		roomDeletion,
+		delaunyTriangulation,
+		MST,
+		roomConnections,
+		addingHallways,
+		addDeletedRooms,
+		done
+	};
+
+	explicit DungeonGenerator(const DungeonParams& params = DungeonParams{});
+	DungeonGenerator(const DungeonGenerator& other) = delete;
+	DungeonGenerator& operator=(const DungeonGenerator& other) = delete;
+	DungeonGenerator(DungeonGenerator&& other) = delete;
+	DungeonGenerator& operator=(DungeonGenerator&& other) = delete;
+	~DungeonGenerator();
+
+	//Throws away the current dungeon and spawns the rooms for a new one
+	void Reset(const DungeonParams& params);
+
+	//Runs a single step of the current stage and returns the stage the generator is in afterwards.
+	//The expensive stages are split up into steps that each do a fixed amount of work. What cannot be split up are the sorts:
+	//the Hilbert sort of the rooms after the deletion and the sort of the edges at the start of the MST, those steps still grow
+	//with the dungeon (about 2 and 4 ms at 10000 rooms). So do a hallway that has to search most of the grid, the parallel
+	//triangulation and the push per step separation when solveSeparation is off
+	Stage Step();
+	//Runs steps until the budget is used up or the dungeon is done, returns true once it is done.
+	//At least one step is run, so it always makes progress
+	bool Advance(double budgetMs);
+	//Runs all of the remaining stages
+	const DungeonResult& Generate();
+
+	Stage GetStage() const { return m_CurrentStage; }
+	bool IsDone() const { return m_CurrentStage == done; }
+	const DungeonParams& GetParams() const { return m_Params; }
+	//Time spent in a stage since the last reset
+	double GetStageSeconds(Stage stage) const { return m_StageSeconds[stage]; }
+	int GetSeparationIterations() const { return m_SeparationIterations; }
+	static const char* GetStageName(Stage stage);
+
+	//Only complete once the generator is done
+	const DungeonResult& GetResult() const { return m_Result; }
+
+	//Editing a dungeon once its rooms are deleted. Only the rooms that change get added to or taken out of the triangulation,
+	//and the graph patches its tree and room connections right away. Run Advance or Generate afterwards to finish the dungeon again,
+	//that only routes the connections the edits changed and the ones of the edited rooms. The first edit routes every connection once more,
+	//after that the hallways are kept per connection: each one gets its whole path, so a corridor can be in there more than once.
+	//Before that the edits simply change what the next stages start with.
+	//Keeps the given number of smallest rooms, like the room deletion would have
+	void SetMinimumNumOfRooms(int minimumNumOfRooms);
+	//Moves a room by the given offset, it can end up overlapping other rooms. Indices outside of the rooms are ignored
+	void MoveRoom(int roomIdx, float x, float y);
+
+private:
+	//How much of a stage one step does
+	static constexpr int m_PointsPerStep{ 256 };
+	static constexpr int m_ConnectionsPerStep{ 16 };
+	static constexpr int m_RoomsPerStep{ 16 };
+	static constexpr int m_RoomsPerSeparationStep{ 1024 };
+	static constexpr int m_EdgesPerStep{ 4096 };
+	static constexpr int m_CellsPerStep{ 1 << 18 };
+	//Below this the threads cost more than they save
+	static constexpr int m_MinPointsForParallelTriangulation{ 4096 };
+
+	DungeonParams m_Params{};
+	Stage m_CurrentStage{ roomSeparation };
+	int m_StageProgress{}; //How far into the current stage the steps got, 0 when it has not started yet
+	double m_StageSeconds[done + 1]{}; //done gets one as well, so every stage can be asked for
+	int m_SeparationIterations{};
+	bool m_IsSeparated{};
+	SeparationState m_SeparationState{};
+
+	RoomStore m_Rooms{};
+	RoomGrid m_RoomGrid{};
+	std::vector<Hallway> m_Hallways{};
+	std::vector<Vertex> m_GraphPoints{}; //Kept so refilling the graph does not allocate
+	Graph m_Graph{};
+	HallwayRouter m_HallwayRouter{};
+	Pcg32 m_HallwayRandom{}; //Used over all the steps of the hallway stage
+	bool m_IsRouterStarted{}; //The hallway stage sized the router's grid and is filling it in
+	std::vector<int> m_AddedBackRooms{}; //Deleted rooms that a hallway goes through, brought back by addingRooms
+	bool m_IsEdited{}; //The dungeon got edited since the last reset, the hallway stage keeps the hallways per connection from then on
+	bool m_AreHallwaysDynamic{}; //m_DynamicHallways holds a hallway for every room connection of the graph
+	DynamicHallways m_DynamicHallways{};
+	std::vector<Graph::ConnectionChange> m_ConnectionChanges{};
+	std::vector<int> m_CrossedRooms{};
+	int m_BossRoomIdx{ -1 };
+	ThreadPool* m_pTriangulationPool{}; //Made the first time a parallel triangulation is done
+
+	DungeonResult m_Result{};
+
+	Pcg32 CreateRandom(Stage stage) const;
+	void SetStage(Stage stage);
+	//All three return true once the stage is finished
+	bool CreateHallways();
+	bool CreateEditedHallways();
+	bool AddDeletedRooms();
+	//Called before an edit changes the room
+	void BeginRoomEdit(int roomIdx);
+	//Undoes the stages after the triangulation, only the rooms in the graph stay alive.
+	//Only touches the rooms those stages changed, so an edit does not go over every room
+	void RestoreGraphRooms();
+	void FillResult();
+};
@@ -0,0 +1,354 @@
+#include "pch.h"
+#include "DungeonMesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "DungeonGenerator.h"
+#include "ResourceManager.h"
+
+namespace
+{
+	//Vertex buffers are newer than what opengl32 exports on Windows, so they are looked up at runtime.
+	//When the driver does not have them the mesh draws from its own memory instead.
+	struct BufferFunctions
+	{
+		PFNGLGENBUFFERSPROC genBuffers{};
+		PFNGLDELETEBUFFERSPROC deleteBuffers{};
+		PFNGLBINDBUFFERPROC bindBuffer{};
+		PFNGLBUFFERDATAPROC bufferData{};
+
+		bool IsAvailable() const { return genBuffers && deleteBuffers && bindBuffer && bufferData; }
+	};
+
+	const BufferFunctions& GetBufferFunctions()
+	{
+		static const BufferFunctions functions{
+			reinterpret_cast<PFNGLGENBUFFERSPROC>(SDL_GL_GetProcAddress("glGenBuffers")),
+			reinterpret_cast<PFNGLDELETEBUFFERSPROC>(SDL_GL_GetProcAddress("glDeleteBuffers")),
+			reinterpret_cast<PFNGLBINDBUFFERPROC>(SDL_GL_GetProcAddress("glBindBuffer")),
+			reinterpret_cast<PFNGLBUFFERDATAPROC>(SDL_GL_GetProcAddress("glBufferData")) };
+		return functions;
+	}
+
+	const Color4f g_HallwayColor{ 76.1f, 69.8f, 50.2f, 1.0f };
+	const Color4f g_RoomColor{ 0.152f, 0.15f, 0.15f, 1.f };
+}
+
+DungeonMesh::DungeonMesh(ResourceManager& resourceManager, const DungeonQuadtree& quadtree)
+	:m_Quadtree{ quadtree }
+	,m_ResourceManager{ resourceManager }
+{
+	//Start loading the icons before the first dungeon needs them
+	for (const auto type : { RoomStore::DEFAULT, RoomStore::BOSS })
+	{
+		if (const char* pIconPath{ GetIconPath(type) })
+			m_ResourceManager.RequestIcon(pIconPath);
+	}
+}
+
+DungeonMesh::~DungeonMesh()
+{
+	const BufferFunctions& functions{ GetBufferFunctions() };
+	if (m_VertexBufferId != 0 && functions.IsAvailable())
+		functions.deleteBuffers(1, &m_VertexBufferId);
+
+	if (m_RasterTextureId != 0)
+		glDeleteTextures(1, &m_RasterTextureId);
+}
+
+void DungeonMesh::Build(const DungeonResult& dungeon)
+{
+	m_Vertices.clear();
+	m_SpecialRooms.clear();
+	m_HallwayVertexStarts.clear();
+	m_RoomVertexStarts.clear();
+	m_SimpleHallwayVertexStarts.clear();
+	m_SimpleRoomVertexStarts.clear();
+	m_IsRasterDirty = true;
+
+	//Same colors and order as drawing the dungeon piece by piece, all hallways first and the rooms on top of them
+	const std::vector<DungeonQuadtree::Item>& items{ m_Quadtree.GetItems() };
+	for (const auto& item : items)
+	{
+		m_HallwayVertexStarts.emplace_back(int(m_Vertices.size()));
+		if (item.type != DungeonQuadtree::ItemType::Hallway) continue;
+
+		const Hallway& hallway{ dungeon.hallways[item.index] };
+		AddLine(hallway.startingPoint, hallway.endPoint, float(hallway.hallwaySize), g_HallwayColor);
+	}
+	m_HallwayVertexStarts.emplace_back(int(m_Vertices.size()));
+
+	const RoomStore& rooms{ dungeon.rooms };
+	for (const auto& item : items)
+	{
+		m_RoomVertexStarts.emplace_back(int(m_Vertices.size()));
+		if (item.type != DungeonQuadtree::ItemType::Room) continue;
+
+		const Rectf rect{ rooms.GetRect(item.index) };
+		AddRoom(rect);
+
+		if (const char* pIconPath{ GetIconPath(rooms.GetType(item.index)) })
+			m_SpecialRooms.emplace_back(SpecialRoom{ rect, m_ResourceManager.RequestIcon(pIconPath) });
+	}
+	m_RoomVertexStarts.emplace_back(int(m_Vertices.size()));
+
+	for (const auto& item : items)
+	{
+		m_SimpleHallwayVertexStarts.emplace_back(int(m_Vertices.size()));
+		if (item.type != DungeonQuadtree::ItemType::Hallway) continue;
+
+		const Hallway& hallway{ dungeon.hallways[item.index] };
+		m_Vertices.emplace_back(MeshVertex{ hallway.startingPoint.x, hallway.startingPoint.y, g_HallwayColor });
+		m_Vertices.emplace_back(MeshVertex{ hallway.endPoint.x, hallway.endPoint.y, g_HallwayColor });
+	}
+	m_SimpleHallwayVertexStarts.emplace_back(int(m_Vertices.size()));
+
+	for (const auto& item : items)
+	{
+		m_SimpleRoomVertexStarts.emplace_back(int(m_Vertices.size()));
+		if (item.type == DungeonQuadtree::ItemType::Room)
+			AddRect(rooms.GetRect(item.index), g_RoomColor);
+	}
+	m_SimpleRoomVertexStarts.emplace_back(int(m_Vertices.size()));
+
+	m_NumOfVertices = int(m_Vertices.size());
+
+	const BufferFunctions& functions{ GetBufferFunctions() };
+	if (!functions.IsAvailable()) return;
+
+	if (m_VertexBufferId == 0)
+		functions.genBuffers(1, &m_VertexBufferId);
+	functions.bindBuffer(GL_ARRAY_BUFFER, m_VertexBufferId);
+	functions.bufferData(GL_ARRAY_BUFFER, GLsizeiptr(m_Vertices.size() * sizeof(MeshVertex)), m_Vertices.data(), GL_STATIC_DRAW);
+	functions.bindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void DungeonMesh::Draw(const Rectf& viewRect, float zoom)
+{
+	if (m_NumOfVertices == 0) return;
+
+	//Anything that was batched before goes below the dungeon
+	utils::FlushDrawBatch();
+
+	//Costs the same no matter how big the dungeon is
+	if (zoom < m_RasterZoom)
+	{
+		if (m_IsRasterDirty)
+			BuildRaster();
+		DrawRaster();
+		return;
+	}
+
+	m_VisibleRanges.clear();
+	m_Quadtree.Query(viewRect, m_VisibleRanges);
+	const bool isSimplified{ zoom < m_SimplifiedZoom };
+
+	const BufferFunctions& functions{ GetBufferFunctions() };
+	const bool useBuffer{ m_VertexBufferId != 0 && functions.IsAvailable() };
+
+	//With a buffer bound the pointers are offsets into it
+	const char* pData{ useBuffer ? nullptr : reinterpret_cast<const char*>(m_Vertices.data()) };
+	if (useBuffer)
+		functions.bindBuffer(GL_ARRAY_BUFFER, m_VertexBufferId);
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glVertexPointer(2, GL_FLOAT, sizeof(MeshVertex), pData + offsetof(MeshVertex, x));
+	glColorPointer(4, GL_FLOAT, sizeof(MeshVertex), pData + offsetof(MeshVertex, color));
+	if (isSimplified)
+	{
+		glLineWidth(1.f);
+		DrawRanges(m_SimpleHallwayVertexStarts, GL_LINES);
+		DrawRanges(m_SimpleRoomVertexStarts, GL_TRIANGLES);
+	}
+	else
+	{
+		DrawRanges(m_HallwayVertexStarts, GL_TRIANGLES);
+		DrawRanges(m_RoomVertexStarts, GL_TRIANGLES);
+	}
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+
+	if (useBuffer)
+		functions.bindBuffer(GL_ARRAY_BUFFER, 0);
+
+	if (isSimplified) return;
+
+	//Centered in the room at their own size
+	for (const auto& room : m_SpecialRooms)
+	{
+		if (!utils::IsOverlapping(room.rect, viewRect)) continue;
+
+		const Point2f iconSize{ m_ResourceManager.GetIconSize(room.iconId) };
+		m_ResourceManager.QueueIcon(room.iconId, Rectf{ room.rect.left + room.rect.width / 2.f - iconSize.x / 2.f,
+			room.rect.bottom + room.rect.height / 2.f - iconSize.y / 2.f, iconSize.x, iconSize.y });
+	}
+	m_ResourceManager.Flush();
+}
+
+const char* DungeonMesh::GetIconPath(RoomStore::SpecialRoomTypes type)
+{
+	switch (type)
+	{
+	case RoomStore::BOSS: return "Assets/boss_icon.png";
+	case RoomStore::DEFAULT: return nullptr;
+	}
+	return nullptr;
+}
+
+void DungeonMesh::AddRoom(const Rectf& rect)
+{
+	AddRect(rect, g_RoomColor);
+
+	//The outline is a line loop around the rect moved in by half of the thickness
+	const float outlineThickness{ Room::GetOutlineThickness() };
+	const Rectf outline{ rect.left + outlineThickness / 2.f, rect.bottom + outlineThickness / 2.f,
+		rect.width - outlineThickness / 2.f, rect.height - outlineThickness / 2.f };
+	const Point2f bottomLeft{ outline.left, outline.bottom };
+	const Point2f bottomRight{ outline.left + outline.width, outline.bottom };
+	const Point2f topRight{ outline.left + outline.width, outline.bottom + outline.height };
+	const Point2f topLeft{ outline.left, outline.bottom + outline.height };
+	const Color4f outlineColor{ 1, 1, 1, 1 };
+	AddLine(bottomLeft, bottomRight, outlineThickness / 2.f, outlineColor);
+	AddLine(bottomRight, topRight, outlineThickness / 2.f, outlineColor);
+	AddLine(topRight, topLeft, outlineThickness / 2.f, outlineColor);
+	AddLine(topLeft, bottomLeft, outlineThickness / 2.f, outlineColor);
+}
+
+void DungeonMesh::DrawRanges(const std::vector<int>& vertexStarts, GLenum mode) const
+{
+	//Items without vertices in this layer leave gaps in the item ranges that can be closed
+	int first{}, end{};
+	for (const auto& range : m_VisibleRanges)
+	{
+		const int rangeFirst{ vertexStarts[range.first] }, rangeEnd{ vertexStarts[range.end] };
+		if (rangeFirst == rangeEnd) continue;
+
+		if (rangeFirst != end)
+		{
+			if (end > first)
+				glDrawArrays(mode, first, end - first);
+			first = rangeFirst;
+		}
+		end = rangeEnd;
+	}
+	if (end > first)
+		glDrawArrays(mode, first, end - first);
+}
+
+void DungeonMesh::BuildRaster()
+{
+	m_IsRasterDirty = false;
+
+	//Big dungeons get fewer texels per unit instead of a bigger texture
+	const Rectf& bounds{ m_Quadtree.GetBounds() };
+	const float scale{ std::min({ m_RasterTexelsPerUnit, m_MaxRasterSize / bounds.width, m_MaxRasterSize / bounds.height }) };
+	const int width{ std::max(1, int(std::ceil(bounds.width * scale))) };
+	const int height{ std::max(1, int(std::ceil(bounds.height * scale))) };
+	m_RasterPixels.assign(size_t(width) * size_t(height) * 4, 0);
+
+	//Hallways go straight along x or y, so their bounds are what they cover
+	const std::vector<DungeonQuadtree::Item>& items{ m_Quadtree.GetItems() };
+	for (const auto& item : items)
+	{
+		if (item.type == DungeonQuadtree::ItemType::Hallway)
+			FillRaster(item.bounds, g_HallwayColor, scale, width, height);
+	}
+	for (const auto& item : items)
+	{
+		if (item.type == DungeonQuadtree::ItemType::Room)
+			FillRaster(item.bounds, g_RoomColor, scale, width, height);
+	}
+
+	if (m_RasterTextureId == 0)
+		glGenTextures(1, &m_RasterTextureId);
+	glBindTexture(GL_TEXTURE_2D, m_RasterTextureId);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_RasterPixels.data());
+	//Smooths it out when it is drawn smaller than it is
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+void DungeonMesh::FillRaster(const Rectf& rect, const Color4f& color, float scale, int width, int height)
+{
+	//Row 0 is the bottom of the dungeon, every texel the rect touches is filled so thin hallways do not disappear
+	const Rectf& bounds{ m_Quadtree.GetBounds() };
+	const int left{ std::max(0, int(std::floor((rect.left - bounds.left) * scale))) };
+	const int bottom{ std::max(0, int(std::floor((rect.bottom - bounds.bottom) * scale))) };
+	const int right{ std::min(width, int(std::ceil((rect.left + rect.width - bounds.left) * scale))) };
+	const int top{ std::min(height, int(std::ceil((rect.bottom + rect.height - bounds.bottom) * scale))) };
+
+	//The colors can be over 1, OpenGL clamps those as well
+	const unsigned char texel[4]{
+		static_cast<unsigned char>(std::clamp(color.r, 0.f, 1.f) * 255.f), static_cast<unsigned char>(std::clamp(color.g, 0.f, 1.f) * 255.f),
+		static_cast<unsigned char>(std::clamp(color.b, 0.f, 1.f) * 255.f), static_cast<unsigned char>(std::clamp(color.a, 0.f, 1.f) * 255.f) };
+	for (int y{ bottom }; y < top; ++y)
+	{
+		for (int x{ left }; x < right; ++x)
+			std::copy(texel, texel + 4, m_RasterPixels.begin() + (size_t(y) * size_t(width) + size_t(x)) * 4);
+	}
+}
+
+void DungeonMesh::DrawRaster() const
+{
+	const Rectf& bounds{ m_Quadtree.GetBounds() };
+	const float left{ bounds.left }, right{ bounds.left + bounds.width };
+	const float bottom{ bounds.bottom }, top{ bounds.bottom + bounds.height };
+
+	glBindTexture(GL_TEXTURE_2D, m_RasterTextureId);
+	glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+	glEnable(GL_TEXTURE_2D);
+	glBegin(GL_QUADS);
+	{
+		glTexCoord2f(0.f, 0.f);
+		glVertex2f(left, bottom);
+
+		glTexCoord2f(0.f, 1.f);
+		glVertex2f(left, top);
+
+		glTexCoord2f(1.f, 1.f);
+		glVertex2f(right, top);
+
+		glTexCoord2f(1.f, 0.f);
+		glVertex2f(right, bottom);
+	}
+	glEnd();
+	glDisable(GL_TEXTURE_2D);
+}
+
+void DungeonMesh::AddQuad(const Point2f& bottomLeft, const Point2f& bottomRight, const Point2f& topRight, const Point2f& topLeft, const Color4f& color)
+{
+	m_Vertices.emplace_back(MeshVertex{ bottomLeft.x, bottomLeft.y, color });
+	m_Vertices.emplace_back(MeshVertex{ bottomRight.x, bottomRight.y, color });
+	m_Vertices.emplace_back(MeshVertex{ topRight.x, topRight.y, color });
+
+	m_Vertices.emplace_back(MeshVertex{ bottomLeft.x, bottomLeft.y, color });
+	m_Vertices.emplace_back(MeshVertex{ topRight.x, topRight.y, color });
+	m_Vertices.emplace_back(MeshVertex{ topLeft.x, topLeft.y, color });
+}
+
+void DungeonMesh::AddRect(const Rectf& rect, const Color4f& color)
+{
+	AddQuad(Point2f{ rect.left, rect.bottom }, Point2f{ rect.left + rect.width, rect.bottom },
+		Point2f{ rect.left + rect.width, rect.bottom + rect.height }, Point2f{ rect.left, rect.bottom + rect.height }, color);
+}
+
+void DungeonMesh::AddLine(const Point2f& start, const Point2f& end, float lineWidth, const Color4f& color)
+{
+	const float directionX{ end.x - start.x }, directionY{ end.y - start.y };
+	const float length{ std::sqrt(directionX * directionX + directionY * directionY) };
+	if (length <= 0.f) return;
+
+	//Half of the width to both sides, and half of it past both ends so the corners of line loops are filled
+	const float halfWidth{ lineWidth / 2.f };
+	const float alongX{ directionX / length * halfWidth }, alongY{ directionY / length * halfWidth };
+	const float sideX{ -alongY }, sideY{ alongX };
+
+	const Point2f from{ start.x - alongX, start.y - alongY };
+	const Point2f to{ end.x + alongX, end.y + alongY };
+	AddQuad(Point2f{ from.x - sideX, from.y - sideY }, Point2f{ to.x - sideX, to.y - sideY },
+		Point2f{ to.x + sideX, to.y + sideY }, Point2f{ from.x + sideX, from.y + sideY }, color);
+}
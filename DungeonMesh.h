@@ -0,0 +1,87 @@
+#pragma once
+#include <vector>
+
+#include "DungeonQuadtree.h"
+#include "RoomStore.h"
+
+class ResourceManager;
+struct DungeonResult;
+
+//Everything of a finished dungeon that never changes again, baked into one vertex buffer.
+//Hallways and room outlines are turned into triangles as well, so drawing it is a single draw call
+//no matter how many rooms there are. The icons of the special rooms come from the icon atlas, in a second draw call.
+//The vertices are laid out in the order of the quadtree items, so only the ranges that are in view get drawn.
+//Zoomed out, the outlines and icons would be smaller than a pixel, so a simpler version of the mesh is drawn instead,
+//and zoomed out even further the whole dungeon is one cached low resolution image.
+class DungeonMesh final
+{
+public:
+	DungeonMesh(ResourceManager& resourceManager, const DungeonQuadtree& quadtree);
+	DungeonMesh(const DungeonMesh& other) = delete;
+	DungeonMesh& operator=(const DungeonMesh& other) = delete;
+	DungeonMesh(DungeonMesh&& other) = delete;
+	DungeonMesh& operator=(DungeonMesh&& other) = delete;
+	~DungeonMesh();
+
+	//Needs the OpenGL context, so call it from the main thread. The quadtree has to be built from the same dungeon first
+	void Build(const DungeonResult& dungeon);
+	//Only what overlaps the view rect, in world space. The zoom picks how detailed it is drawn
+	void Draw(const Rectf& viewRect, float zoom);
+
+private:
+	static constexpr float m_SimplifiedZoom{ 0.5f }; //Below this the outlines are thinner than a pixel
+	static constexpr float m_RasterZoom{ 0.25f };
+	//About a texel per pixel when the raster starts being used
+	static constexpr float m_RasterTexelsPerUnit{ m_RasterZoom };
+	static constexpr int m_MaxRasterSize{ 1024 };
+
+	struct MeshVertex
+	{
+		float x, y;
+		Color4f color;
+	};
+
+	std::vector<MeshVertex> m_Vertices{}; //Kept to draw from when there are no vertex buffers, and to reuse the memory
+	GLuint m_VertexBufferId{};
+	int m_NumOfVertices{};
+
+	//Hallways are all drawn before the rooms, so each of them has its own vertex range per quadtree item.
+	//Item i goes from starts[i] to starts[i + 1]
+	std::vector<int> m_HallwayVertexStarts{};
+	std::vector<int> m_RoomVertexStarts{};
+	//Hallways as lines and rooms without outlines, the same layout in the same buffer
+	std::vector<int> m_SimpleHallwayVertexStarts{};
+	std::vector<int> m_SimpleRoomVertexStarts{};
+
+	//Made the first time it is needed for a dungeon
+	std::vector<unsigned char> m_RasterPixels{};
+	GLuint m_RasterTextureId{};
+	bool m_IsRasterDirty{ true };
+
+	const DungeonQuadtree& m_Quadtree;
+	std::vector<DungeonQuadtree::ItemRange> m_VisibleRanges{};
+
+	//Icons are looked up when drawing, they can still be loading when the dungeon is built
+	struct SpecialRoom
+	{
+		Rectf rect;
+		int iconId;
+	};
+
+	ResourceManager& m_ResourceManager;
+	std::vector<SpecialRoom> m_SpecialRooms{};
+
+	//nullptr for rooms without an icon, add new special room types here
+	static const char* GetIconPath(RoomStore::SpecialRoomTypes type);
+
+	void AddRoom(const Rectf& rect);
+	void DrawRanges(const std::vector<int>& vertexStarts, GLenum mode) const;
+	void BuildRaster();
+	void FillRaster(const Rectf& rect, const Color4f& color, float scale, int width, int height);
+	void DrawRaster() const;
+
+	void AddQuad(const Point2f& bottomLeft, const Point2f& bottomRight, const Point2f& topRight, const Point2f& topLeft, const Color4f& color);
+	void AddRect(const Rectf& rect, const Color4f& color);
+	//Same area a line of that width covers
+	void AddLine(const Point2f& start, const Point2f& end, float lineWidth, const Color4f& color);
+};
@@ -0,0 +1,129 @@
+#include "DungeonPrefetcher.h"
+
+#include <algorithm>
+
+DungeonPrefetcher::DungeonPrefetcher(const DungeonParams& params, int prefetchDepth)
+	:m_PrefetchDepth{ std::max(0, prefetchDepth) },
+	m_Dungeons(size_t(m_PrefetchDepth) + 1),
+	m_FinishedDungeons{ m_Dungeons.size() },
+	m_FreeDungeons{ m_Dungeons.size() },
+	m_Params{ params }
+{
+	if (m_PrefetchDepth == 0) return;
+
+	for (auto& dungeon : m_Dungeons)
+		m_FreeDungeons.TryPush(&dungeon);
+
+	m_Worker = std::thread{ &DungeonPrefetcher::WorkerLoop, this };
+}
+
+DungeonPrefetcher::~DungeonPrefetcher()
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+		m_IsStopping = true;
+	}
+	m_WakeUp.notify_one();
+
+	if (m_Worker.joinable())
+		m_Worker.join();
+}
+
+void DungeonPrefetcher::SetParams(const DungeonParams& params)
+{
+	std::lock_guard<std::mutex> lock{ m_Mutex };
+	m_Params = params;
+	++m_ParamsVersion;
+	m_NumOfDungeonsWithParams = 0;
+	m_LatestParamsVersion = m_ParamsVersion;
+}
+
+const DungeonResult* DungeonPrefetcher::TryGetDungeon(double generationBudgetMs)
+{
+	//Without a worker the only dungeon gets generated right here, spread over as many calls as it needs
+	if (m_PrefetchDepth == 0)
+	{
+		PrefetchedDungeon& dungeon{ m_Dungeons.front() };
+		if (!m_IsGenerating || dungeon.paramsVersion != m_LatestParamsVersion)
+		{
+			//The only dungeon gets new parameters, so it is not the one on screen anymore
+			m_pDungeonOnScreen = nullptr;
+			BeginGenerating(dungeon);
+			m_IsGenerating = true;
+		}
+		if (!m_Generator.Advance(generationBudgetMs)) return nullptr;
+
+		m_IsGenerating = false;
+		dungeon.dungeon = m_Generator.GetResult();
+		m_pDungeonOnScreen = &dungeon;
+		return &dungeon.dungeon;
+	}
+
+	PrefetchedDungeon* pDungeon{};
+	while (m_FinishedDungeons.TryPop(pDungeon))
+	{
+		//Made before the parameters changed, give it straight back
+		if (pDungeon->paramsVersion != m_LatestParamsVersion)
+		{
+			ReturnDungeon(pDungeon);
+			continue;
+		}
+
+		if (m_pDungeonOnScreen) ReturnDungeon(m_pDungeonOnScreen);
+		m_pDungeonOnScreen = pDungeon;
+		return &pDungeon->dungeon;
+	}
+
+	return nullptr;
+}
+
+void DungeonPrefetcher::WorkerLoop()
+{
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock{ m_Mutex };
+			m_WakeUp.wait(lock, [this]() { return m_IsStopping || !m_FreeDungeons.IsEmpty(); });
+			if (m_IsStopping) return;
+		}
+
+		PrefetchedDungeon* pDungeon{};
+		m_FreeDungeons.TryPop(pDungeon);
+
+		Generate(*pDungeon);
+		m_FinishedDungeons.TryPush(pDungeon);
+	}
+}
+
+void DungeonPrefetcher::BeginGenerating(PrefetchedDungeon& dungeon)
+{
+	DungeonParams params{};
+	{
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+		params = m_Params;
+		params.seed += m_NumOfDungeonsWithParams++;
+		dungeon.paramsVersion = m_ParamsVersion;
+	}
+	dungeon.params = params;
+
+	m_Generator.Reset(params);
+}
+
+void DungeonPrefetcher::Generate(PrefetchedDungeon& dungeon)
+{
+	BeginGenerating(dungeon);
+	//Copying into the old result reuses the memory it already has
+	dungeon.dungeon = m_Generator.Generate();
+}
+
+void DungeonPrefetcher::ReturnDungeon(PrefetchedDungeon* pDungeon)
+{
+	//The queue can hold every dungeon, so this never fails
+	m_FreeDungeons.TryPush(pDungeon);
+
+	//Taking the lock makes sure the worker is either waiting or will see the dungeon before it waits
+	{
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+	}
+	m_WakeUp.notify_one();
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "DungeonGenerator.h"
+#include "SpscQueue.h"
+
+//Generates the next dungeons on a worker thread while the current one is on screen.
+//Finished dungeons are handed over through a lock-free queue and the ones that are not needed anymore go back
+//to the worker through a second one, so the results get reused instead of being allocated for every dungeon.
+class DungeonPrefetcher final
+{
+public:
+	//The depth is how many dungeons are generated ahead, 0 generates on the calling thread a slice at a time when one is asked for
+	DungeonPrefetcher(const DungeonParams& params, int prefetchDepth);
+	DungeonPrefetcher(const DungeonPrefetcher& other) = delete;
+	DungeonPrefetcher& operator=(const DungeonPrefetcher& other) = delete;
+	DungeonPrefetcher(DungeonPrefetcher&& other) = delete;
+	DungeonPrefetcher& operator=(DungeonPrefetcher&& other) = delete;
+	~DungeonPrefetcher();
+
+	//Dungeons made with older parameters get thrown away. Every dungeon after this uses the next seed.
+	void SetParams(const DungeonParams& params);
+
+	//Gives the next finished dungeon, or nullptr when none is ready yet.
+	//The dungeon stays valid until the next call that returns a new one, the old one then goes back to the worker.
+	//Without a worker every call generates for at most about the budget and picks up where the last call stopped.
+	const DungeonResult* TryGetDungeon(double generationBudgetMs);
+
+	int GetPrefetchDepth() const { return m_PrefetchDepth; }
+	//What the dungeon TryGetDungeon gave last was made with, generating with these gives the same dungeon again.
+	//nullptr until TryGetDungeon has returned a dungeon
+	const DungeonParams* GetParamsOnScreen() const { return m_pDungeonOnScreen ? &m_pDungeonOnScreen->params : nullptr; }
+
+private:
+	struct PrefetchedDungeon
+	{
+		DungeonResult dungeon{};
+		DungeonParams params{};
+		unsigned int paramsVersion{};
+	};
+
+	const int m_PrefetchDepth;
+	DungeonGenerator m_Generator{};
+
+	//One dungeon for every slot ahead, plus the one that is on screen
+	std::vector<PrefetchedDungeon> m_Dungeons;
+	PrefetchedDungeon* m_pDungeonOnScreen{};
+	SpscQueue<PrefetchedDungeon*> m_FinishedDungeons; //Worker to caller
+	SpscQueue<PrefetchedDungeon*> m_FreeDungeons; //Caller to worker
+
+	//Guards the parameters and is used to wake the worker up
+	std::mutex m_Mutex{};
+	std::condition_variable m_WakeUp{};
+	DungeonParams m_Params{};
+	unsigned int m_ParamsVersion{};
+	unsigned int m_NumOfDungeonsWithParams{};
+	std::atomic<unsigned int> m_LatestParamsVersion{ 0 };
+	bool m_IsStopping{ false };
+	bool m_IsGenerating{ false }; //Only used without a worker, a dungeon is partly generated
+
+	std::thread m_Worker{};
+
+	void WorkerLoop();
+	void BeginGenerating(PrefetchedDungeon& dungeon);
+	void Generate(PrefetchedDungeon& dungeon);
+	void ReturnDungeon(PrefetchedDungeon* pDungeon);
+};
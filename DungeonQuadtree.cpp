@@ -0,0 +1,179 @@
+#include "DungeonQuadtree.h"
+
+#include <algorithm>
+
+#include "DungeonGenerator.h"
+
+void DungeonQuadtree::Build(const DungeonResult& dungeon)
+{
+	m_Nodes.clear();
+	m_Items.clear();
+	m_BuildItems.clear();
+
+	const RoomStore& rooms{ dungeon.rooms };
+	for (int roomIdx{}; roomIdx < rooms.GetSize(); ++roomIdx)
+	{
+		if (rooms.IsAlive(roomIdx))
+			m_BuildItems.emplace_back(BuildItem{ Item{ rooms.GetRect(roomIdx), roomIdx, ItemType::Room }, -1 });
+	}
+
+	//Hallways are drawn half of their size past both ends, so the bounds grow by that much in every direction
+	for (int hallwayIdx{}; hallwayIdx < int(dungeon.hallways.size()); ++hallwayIdx)
+	{
+		const Hallway& hallway{ dungeon.hallways[hallwayIdx] };
+		const float halfSize{ hallway.hallwaySize / 2.f };
+		const float left{ std::min(hallway.startingPoint.x, hallway.endPoint.x) - halfSize };
+		const float bottom{ std::min(hallway.startingPoint.y, hallway.endPoint.y) - halfSize };
+		const float right{ std::max(hallway.startingPoint.x, hallway.endPoint.x) + halfSize };
+		const float top{ std::max(hallway.startingPoint.y, hallway.endPoint.y) + halfSize };
+		m_BuildItems.emplace_back(BuildItem{ Item{ Rectf{ left, bottom, right - left, top - bottom }, hallwayIdx, ItemType::Hallway }, -1 });
+	}
+
+	if (m_BuildItems.empty())
+	{
+		m_Bounds = Rectf{};
+		return;
+	}
+
+	float left{ m_BuildItems[0].item.bounds.left }, bottom{ m_BuildItems[0].item.bounds.bottom };
+	float right{ left + m_BuildItems[0].item.bounds.width }, top{ bottom + m_BuildItems[0].item.bounds.height };
+	for (const auto& buildItem : m_BuildItems)
+	{
+		const Rectf& bounds{ buildItem.item.bounds };
+		left = std::min(left, bounds.left);
+		bottom = std::min(bottom, bounds.bottom);
+		right = std::max(right, bounds.left + bounds.width);
+		top = std::max(top, bounds.bottom + bounds.height);
+	}
+	m_Bounds = Rectf{ left, bottom, right - left, top - bottom };
+
+	m_Items.reserve(m_BuildItems.size());
+	BuildNode(m_Bounds, 0, int(m_BuildItems.size()), 0);
+}
+
+void DungeonQuadtree::Query(const Rectf& area, std::vector<ItemRange>& rangesOut) const
+{
+	if (!m_Nodes.empty())
+		QueryNode(0, area, rangesOut);
+}
+
+int DungeonQuadtree::PickRoom(const Point2f& point) const
+{
+	if (m_Nodes.empty() || !utils::IsPointInRect(point, m_Bounds)) return -1;
+
+	//Items are fully inside their node, so only the path of nodes under the point can have the room
+	int nodeIdx{ 0 };
+	while (nodeIdx != -1)
+	{
+		const Node& node{ m_Nodes[nodeIdx] };
+		for (int itemIdx{ node.firstItem }; itemIdx < node.ownItemsEnd; ++itemIdx)
+		{
+			const Item& item{ m_Items[itemIdx] };
+			if (item.type == ItemType::Room && utils::IsPointInRect(point, item.bounds))
+				return item.index;
+		}
+
+		int nextNodeIdx{ -1 };
+		for (const int childIdx : node.children)
+		{
+			if (childIdx != -1 && utils::IsPointInRect(point, m_Nodes[childIdx].bounds))
+			{
+				nextNodeIdx = childIdx;
+				break;
+			}
+		}
+		nodeIdx = nextNodeIdx;
+	}
+	return -1;
+}
+
+int DungeonQuadtree::BuildNode(const Rectf& bounds, int firstBuildItem, int endBuildItem, int depth)
+{
+	const int nodeIdx{ int(m_Nodes.size()) };
+	m_Nodes.emplace_back(Node{ bounds, int(m_Items.size()), 0, 0, { -1, -1, -1, -1 } });
+
+	const bool doSplit{ endBuildItem - firstBuildItem > m_MaxItemsPerNode && depth < m_MaxDepth };
+	for (int i{ firstBuildItem }; i < endBuildItem; ++i)
+	{
+		BuildItem& buildItem{ m_BuildItems[i] };
+		buildItem.quadrant = -1;
+		for (int quadrant{}; doSplit && quadrant < 4 && buildItem.quadrant == -1; ++quadrant)
+		{
+			if (Contains(GetQuadrant(bounds, quadrant), buildItem.item.bounds))
+				buildItem.quadrant = quadrant;
+		}
+	}
+
+	//The items that stay in this node first, then the ones of every child in order
+	std::stable_sort(m_BuildItems.begin() + firstBuildItem, m_BuildItems.begin() + endBuildItem,
+		[](const BuildItem& a, const BuildItem& b) { return a.quadrant < b.quadrant; });
+
+	int childBegin{ firstBuildItem };
+	while (childBegin < endBuildItem && m_BuildItems[childBegin].quadrant == -1)
+		m_Items.emplace_back(m_BuildItems[childBegin++].item);
+	m_Nodes[nodeIdx].ownItemsEnd = int(m_Items.size());
+
+	for (int quadrant{}; quadrant < 4; ++quadrant)
+	{
+		int childEnd{ childBegin };
+		while (childEnd < endBuildItem && m_BuildItems[childEnd].quadrant == quadrant)
+			++childEnd;
+		if (childEnd == childBegin) continue;
+
+		//Not through a reference, building the child can move the nodes
+		const int childIdx{ BuildNode(GetQuadrant(bounds, quadrant), childBegin, childEnd, depth + 1) };
+		m_Nodes[nodeIdx].children[quadrant] = childIdx;
+		childBegin = childEnd;
+	}
+
+	m_Nodes[nodeIdx].subtreeEnd = int(m_Items.size());
+	return nodeIdx;
+}
+
+void DungeonQuadtree::QueryNode(int nodeIdx, const Rectf& area, std::vector<ItemRange>& rangesOut) const
+{
+	const Node& node{ m_Nodes[nodeIdx] };
+	if (!utils::IsOverlapping(node.bounds, area)) return;
+
+	//Everything under a node that is completely in the area overlaps it
+	if (Contains(area, node.bounds))
+	{
+		AddRange(node.firstItem, node.subtreeEnd, rangesOut);
+		return;
+	}
+
+	for (int itemIdx{ node.firstItem }; itemIdx < node.ownItemsEnd; ++itemIdx)
+	{
+		if (utils::IsOverlapping(m_Items[itemIdx].bounds, area))
+			AddRange(itemIdx, itemIdx + 1, rangesOut);
+	}
+
+	for (const int childIdx : node.children)
+	{
+		if (childIdx != -1)
+			QueryNode(childIdx, area, rangesOut);
+	}
+}
+
+void DungeonQuadtree::AddRange(int first, int end, std::vector<ItemRange>& rangesOut)
+{
+	if (!rangesOut.empty() && rangesOut.back().end == first)
+		rangesOut.back().end = end;
+	else
+		rangesOut.emplace_back(ItemRange{ first, end });
+}
+
+Rectf DungeonQuadtree::GetQuadrant(const Rectf& bounds, int quadrant)
+{
+	//0 is the bottom left, then counter clockwise
+	const float halfWidth{ bounds.width / 2.f }, halfHeight{ bounds.height / 2.f };
+	const float left{ quadrant == 1 || quadrant == 2 ? bounds.left + halfWidth : bounds.left };
+	const float bottom{ quadrant >= 2 ? bounds.bottom + halfHeight : bounds.bottom };
+	return Rectf{ left, bottom, halfWidth, halfHeight };
+}
+
+bool DungeonQuadtree::Contains(const Rectf& outer, const Rectf& inner)
+{
+	return inner.left >= outer.left && inner.bottom >= outer.bottom &&
+		inner.left + inner.width <= outer.left + outer.width && inner.bottom + inner.height <= outer.bottom + outer.height;
+}
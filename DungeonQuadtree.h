@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "structs.h"
+
+struct DungeonResult;
+
+//Spatial index over the rooms and hallways of a finished dungeon, built once when the dungeon comes in.
+//Every item is kept in the smallest node that fully contains it, and the items are stored in depth first order,
+//so all items under a node are one contiguous range. Whatever is drawn per item can be laid out the same way.
+class DungeonQuadtree final
+{
+public:
+	enum class ItemType : uint8_t
+	{
+		Room,
+		Hallway
+	};
+
+	struct Item
+	{
+		Rectf bounds;
+		int index; //Into the room store or the hallways of the dungeon
+		ItemType type;
+	};
+
+	//Items [first, end)
+	struct ItemRange
+	{
+		int first;
+		int end;
+	};
+
+	DungeonQuadtree() = default;
+
+	//Only the alive rooms are added, deleted ones are not drawn and cannot be picked
+	void Build(const DungeonResult& dungeon);
+
+	//Around everything in the dungeon, empty when there is nothing in it
+	const Rectf& GetBounds() const { return m_Bounds; }
+	const std::vector<Item>& GetItems() const { return m_Items; }
+
+	//Adds the ranges of the items that overlap the area, ranges that touch are merged into one
+	void Query(const Rectf& area, std::vector<ItemRange>& rangesOut) const;
+	//Index of the alive room under the point, -1 when there is none
+	int PickRoom(const Point2f& point) const;
+
+private:
+	static constexpr int m_MaxItemsPerNode{ 8 };
+	static constexpr int m_MaxDepth{ 10 };
+
+	struct Node
+	{
+		Rectf bounds;
+		int firstItem; //Items that straddle the children come first
+		int ownItemsEnd;
+		int subtreeEnd;
+		int children[4]; //-1 when the node was not split
+	};
+
+	//An item and the child it fits in while the tree is being built, -1 when it straddles them
+	struct BuildItem
+	{
+		Item item;
+		int quadrant;
+	};
+
+	Rectf m_Bounds{};
+	std::vector<Node> m_Nodes{};
+	std::vector<Item> m_Items{};
+	std::vector<BuildItem> m_BuildItems{};
+
+	int BuildNode(const Rectf& bounds, int firstBuildItem, int endBuildItem, int depth);
+	void QueryNode(int nodeIdx, const Rectf& area, std::vector<ItemRange>& rangesOut) const;
+	static void AddRange(int first, int end, std::vector<ItemRange>& rangesOut);
+	static Rectf GetQuadrant(const Rectf& bounds, int quadrant);
+	static bool Contains(const Rectf& outer, const Rectf& inner);
+};
@@ -0,0 +1,351 @@
+#include "DynamicHallways.h"
+
+#include <algorithm>
+#include <cmath>
+
+void DynamicHallways::Begin(const RoomStore& rooms)
+{
+	const int numOfRooms{ rooms.GetSize() };
+	m_Connections.clear();
+	m_FreeConnections.clear();
+	m_FirstConnections.assign(numOfRooms, -1);
+	m_WaitingConnections.clear();
+	m_Hallways.clear();
+	m_NumOfUsedHallways = 0;
+	m_HallwayCounts.assign(numOfRooms, 0);
+	m_CrossedRooms.clear();
+	m_IsCrossedRoomListed.assign(numOfRooms, false);
+	m_EditedRooms.clear();
+	m_IsRoomEdited.assign(numOfRooms, false);
+	m_RoomStamps.assign(numOfRooms, 0);
+	m_CurrentStamp = 0;
+
+	//Deleted rooms go in as well, hallways can bring them back
+	float left{}, bottom{}, right{}, top{};
+	for (int roomIdx{}; roomIdx < numOfRooms; ++roomIdx)
+	{
+		const Rectf rect{ rooms.GetRect(roomIdx) };
+		if (roomIdx == 0)
+		{
+			left = right = rect.left;
+			bottom = top = rect.bottom;
+		}
+		left = std::min(left, rect.left);
+		bottom = std::min(bottom, rect.bottom);
+		right = std::max(right, rect.left + rect.width);
+		top = std::max(top, rect.bottom + rect.height);
+	}
+	m_BucketLeft = left;
+	m_BucketBottom = bottom;
+	m_NumOfBucketsX = std::max(1, int(std::ceil((right - left) / m_BucketSize)));
+	m_NumOfBucketsY = std::max(1, int(std::ceil((top - bottom) / m_BucketSize)));
+
+	//Clearing instead of assigning keeps the memory of the buckets
+	m_Buckets.resize(size_t(m_NumOfBucketsX) * size_t(m_NumOfBucketsY));
+	for (auto& bucket : m_Buckets)
+		bucket.clear();
+	for (int roomIdx{}; roomIdx < numOfRooms; ++roomIdx)
+		AddToBuckets(roomIdx, rooms.GetRect(roomIdx));
+}
+
+void DynamicHallways::AddConnection(int roomA, int roomB)
+{
+	if (FindConnection(roomA, roomB) != -1) return;
+
+	int connectionIdx{};
+	if (m_FreeConnections.empty())
+	{
+		connectionIdx = int(m_Connections.size());
+		m_Connections.emplace_back();
+	}
+	else
+	{
+		connectionIdx = m_FreeConnections.back();
+		m_FreeConnections.pop_back();
+	}
+
+	m_Connections[connectionIdx] = RoutedConnection{ { roomA, roomB }, { m_FirstConnections[roomA], m_FirstConnections[roomB] }, 0, 0, false, true };
+	m_FirstConnections[roomA] = connectionIdx;
+	m_FirstConnections[roomB] = connectionIdx;
+	m_WaitingConnections.emplace_back(connectionIdx);
+}
+
+void DynamicHallways::BeginRoomEdit(const RoomStore& rooms, int roomIdx)
+{
+	//Only the first edit since the last ApplyEdits knows where the room is on the grid
+	if (m_IsRoomEdited[roomIdx]) return;
+
+	m_IsRoomEdited[roomIdx] = true;
+	m_EditedRooms.emplace_back(EditedRoom{ roomIdx, rooms.GetRect(roomIdx) });
+}
+
+bool DynamicHallways::ApplyEdits(const RoomStore& rooms, const std::vector<Graph::ConnectionChange>& changes, HallwayRouter* pRouter)
+{
+	if (pRouter)
+	{
+		for (const auto& editedRoom : m_EditedRooms)
+		{
+			if (rooms.IsAlive(editedRoom.roomIdx) && !pRouter->IsOnGrid(rooms.GetRect(editedRoom.roomIdx))) return false;
+		}
+	}
+
+	for (const auto& change : changes)
+	{
+		if (change.isAdded)
+		{
+			AddConnection(change.roomA, change.roomB);
+			continue;
+		}
+
+		const int connectionIdx{ FindConnection(change.roomA, change.roomB) };
+		if (connectionIdx != -1) RemoveConnection(connectionIdx, rooms, pRouter);
+	}
+
+	//The hallways of the edited rooms start or end somewhere else now
+	for (const auto& editedRoom : m_EditedRooms)
+	{
+		const int roomIdx{ editedRoom.roomIdx };
+		if (pRouter)
+		{
+			pRouter->RemoveRoom(editedRoom.rect, roomIdx);
+			if (rooms.IsAlive(roomIdx)) pRouter->AddRoom(rooms, roomIdx);
+		}
+		RemoveFromBuckets(roomIdx, editedRoom.rect);
+		AddToBuckets(roomIdx, rooms.GetRect(roomIdx));
+
+		for (int connectionIdx{ m_FirstConnections[roomIdx] }; connectionIdx != -1;)
+		{
+			const RoutedConnection& connection{ m_Connections[connectionIdx] };
+			const int nextConnectionIdx{ connection.next[connection.rooms[0] == roomIdx ? 0 : 1] };
+			Reroute(connectionIdx, rooms, pRouter);
+			connectionIdx = nextConnectionIdx;
+		}
+	}
+
+	//Counting the hallways through an edited room is the one part that goes over every hallway, no routing happens in it.
+	//Hallways cannot go through the rooms in the graph, so the ones that go through such a room now have to find another way
+	for (const auto& editedRoom : m_EditedRooms)
+	{
+		const int roomIdx{ editedRoom.roomIdx };
+		const Rectf rect{ rooms.GetRect(roomIdx) };
+		const bool isObstacle{ pRouter && rooms.IsAlive(roomIdx) };
+
+		int numOfHallways{};
+		m_ConnectionsToReroute.clear();
+		for (int connectionIdx{}; connectionIdx < int(m_Connections.size()); ++connectionIdx)
+		{
+			const RoutedConnection& connection{ m_Connections[connectionIdx] };
+			if (connection.rooms[0] == roomIdx || connection.rooms[1] == roomIdx) continue;
+
+			bool isCrossing{ false };
+			for (int hallwayIdx{ connection.firstHallway }; hallwayIdx < connection.firstHallway + connection.numOfHallways; ++hallwayIdx)
+			{
+				float minFlt{}, maxFlt{};
+				if (utils::IntersectRectLine(rect, m_Hallways[hallwayIdx].startingPoint, m_Hallways[hallwayIdx].endPoint, minFlt, maxFlt))
+				{
+					++numOfHallways;
+					isCrossing = true;
+				}
+			}
+			if (isCrossing && isObstacle && connection.isOnGrid) m_ConnectionsToReroute.emplace_back(connectionIdx);
+		}
+
+		AddToCount(roomIdx, numOfHallways - m_HallwayCounts[roomIdx]);
+		for (const int connectionIdx : m_ConnectionsToReroute)
+			Reroute(connectionIdx, rooms, pRouter);
+	}
+
+	for (const auto& editedRoom : m_EditedRooms)
+		m_IsRoomEdited[editedRoom.roomIdx] = false;
+	m_EditedRooms.clear();
+
+	if (int(m_Hallways.size()) > 2 * m_NumOfUsedHallways + 1024) Compact();
+	return true;
+}
+
+bool DynamicHallways::ContinueRouting(const RoomStore& rooms, HallwayRouter* pRouter, int maxConnections, Pcg32& random)
+{
+	int numOfRouted{};
+	while (!m_WaitingConnections.empty() && numOfRouted < maxConnections)
+	{
+		const int connectionIdx{ m_WaitingConnections.back() };
+		m_WaitingConnections.pop_back();
+
+		//A connection can be in line more than once, and taken out while it waited
+		RoutedConnection& connection{ m_Connections[connectionIdx] };
+		if (!connection.isWaiting) continue;
+		++numOfRouted;
+
+		//Rooms that are walled in by other rooms still get the straight hallways
+		m_Path.clear();
+		connection.isOnGrid = pRouter && pRouter->Route(rooms, connection.rooms[0], connection.rooms[1], m_Path, true);
+		if (!connection.isOnGrid)
+			Room::ConnectRooms(rooms, connection.rooms[0], connection.rooms[1], m_Path, random);
+
+		connection.firstHallway = int(m_Hallways.size());
+		connection.numOfHallways = int(m_Path.size());
+		connection.isWaiting = false;
+		m_Hallways.insert(m_Hallways.end(), m_Path.begin(), m_Path.end());
+		m_NumOfUsedHallways += connection.numOfHallways;
+		for (const auto& hallway : m_Path)
+			CountHallway(rooms, hallway, connection.rooms, 1);
+	}
+	return m_WaitingConnections.empty();
+}
+
+void DynamicHallways::GetHallways(std::vector<Hallway>& hallways) const
+{
+	hallways.clear();
+	for (const auto& connection : m_Connections)
+		hallways.insert(hallways.end(), m_Hallways.begin() + connection.firstHallway, m_Hallways.begin() + connection.firstHallway + connection.numOfHallways);
+}
+
+void DynamicHallways::GetCrossedRooms(std::vector<int>& roomsOut)
+{
+	//The rooms that lost their last hallway since the last call drop out of the list here
+	roomsOut.clear();
+	for (const int roomIdx : m_CrossedRooms)
+	{
+		if (m_HallwayCounts[roomIdx] > 0) roomsOut.emplace_back(roomIdx);
+		else m_IsCrossedRoomListed[roomIdx] = false;
+	}
+	m_CrossedRooms = roomsOut;
+}
+
+int DynamicHallways::FindConnection(int roomA, int roomB) const
+{
+	for (int connectionIdx{ m_FirstConnections[roomA] }; connectionIdx != -1;)
+	{
+		const RoutedConnection& connection{ m_Connections[connectionIdx] };
+		if (connection.rooms[0] == roomB || connection.rooms[1] == roomB) return connectionIdx;
+		connectionIdx = connection.next[connection.rooms[0] == roomA ? 0 : 1];
+	}
+	return -1;
+}
+
+void DynamicHallways::RemoveConnection(int connectionIdx, const RoomStore& rooms, HallwayRouter* pRouter)
+{
+	ClearHallways(connectionIdx, rooms, pRouter);
+
+	RoutedConnection& connection{ m_Connections[connectionIdx] };
+	for (int side{}; side < 2; ++side)
+	{
+		//Unlink it from the list of the room on this side
+		const int roomIdx{ connection.rooms[side] };
+		int* pLink{ &m_FirstConnections[roomIdx] };
+		while (*pLink != connectionIdx)
+		{
+			RoutedConnection& other{ m_Connections[*pLink] };
+			pLink = &other.next[other.rooms[0] == roomIdx ? 0 : 1];
+		}
+		*pLink = connection.next[side];
+	}
+
+	connection = RoutedConnection{ { -1, -1 }, { -1, -1 }, 0, 0, false, false };
+	m_FreeConnections.emplace_back(connectionIdx);
+}
+
+void DynamicHallways::Reroute(int connectionIdx, const RoomStore& rooms, HallwayRouter* pRouter)
+{
+	RoutedConnection& connection{ m_Connections[connectionIdx] };
+	if (connection.isWaiting) return;
+
+	ClearHallways(connectionIdx, rooms, pRouter);
+	connection.isWaiting = true;
+	m_WaitingConnections.emplace_back(connectionIdx);
+}
+
+void DynamicHallways::ClearHallways(int connectionIdx, const RoomStore& rooms, HallwayRouter* pRouter)
+{
+	RoutedConnection& connection{ m_Connections[connectionIdx] };
+	if (pRouter && connection.isOnGrid) pRouter->RemovePath(m_Hallways, connection.firstHallway, connection.numOfHallways);
+	for (int hallwayIdx{ connection.firstHallway }; hallwayIdx < connection.firstHallway + connection.numOfHallways; ++hallwayIdx)
+		CountHallway(rooms, m_Hallways[hallwayIdx], connection.rooms, -1);
+
+	m_NumOfUsedHallways -= connection.numOfHallways;
+	connection.firstHallway = 0;
+	connection.numOfHallways = 0;
+	connection.isOnGrid = false;
+}
+
+void DynamicHallways::CountHallway(const RoomStore& rooms, const Hallway& hallway, const int (&ownRooms)[2], int amount)
+{
+	const Rectf bounds{ std::min(hallway.startingPoint.x, hallway.endPoint.x), std::min(hallway.startingPoint.y, hallway.endPoint.y),
+		std::abs(hallway.endPoint.x - hallway.startingPoint.x), std::abs(hallway.endPoint.y - hallway.startingPoint.y) };
+	int firstX{}, lastX{}, firstY{}, lastY{};
+	GetBuckets(bounds, firstX, lastX, firstY, lastY);
+
+	//A room can be in more than one of the buckets, the stamp makes sure it only gets counted once
+	++m_CurrentStamp;
+	for (int y{ firstY }; y <= lastY; ++y)
+	{
+		for (int x{ firstX }; x <= lastX; ++x)
+		{
+			for (const int roomIdx : m_Buckets[y * m_NumOfBucketsX + x])
+			{
+				if (m_RoomStamps[roomIdx] == m_CurrentStamp || roomIdx == ownRooms[0] || roomIdx == ownRooms[1]) continue;
+				m_RoomStamps[roomIdx] = m_CurrentStamp;
+
+				float minFlt{}, maxFlt{};
+				if (utils::IntersectRectLine(rooms.GetRect(roomIdx), hallway.startingPoint, hallway.endPoint, minFlt, maxFlt))
+					AddToCount(roomIdx, amount);
+			}
+		}
+	}
+}
+
+void DynamicHallways::AddToCount(int roomIdx, int amount)
+{
+	m_HallwayCounts[roomIdx] += amount;
+	if (m_HallwayCounts[roomIdx] > 0 && !m_IsCrossedRoomListed[roomIdx])
+	{
+		m_IsCrossedRoomListed[roomIdx] = true;
+		m_CrossedRooms.emplace_back(roomIdx);
+	}
+}
+
+void DynamicHallways::Compact()
+{
+	m_CompactedHallways.clear();
+	for (auto& connection : m_Connections)
+	{
+		const int firstHallway{ int(m_CompactedHallways.size()) };
+		m_CompactedHallways.insert(m_CompactedHallways.end(), m_Hallways.begin() + connection.firstHallway,
+			m_Hallways.begin() + connection.firstHallway + connection.numOfHallways);
+		connection.firstHallway = firstHallway;
+	}
+	m_Hallways.swap(m_CompactedHallways);
+}
+
+void DynamicHallways::GetBuckets(const Rectf& rect, int& firstX, int& lastX, int& firstY, int& lastY) const
+{
+	firstX = std::clamp(int(std::floor((rect.left - m_BucketLeft) / m_BucketSize)), 0, m_NumOfBucketsX - 1);
+	lastX = std::clamp(int(std::floor((rect.left + rect.width - m_BucketLeft) / m_BucketSize)), 0, m_NumOfBucketsX - 1);
+	firstY = std::clamp(int(std::floor((rect.bottom - m_BucketBottom) / m_BucketSize)), 0, m_NumOfBucketsY - 1);
+	lastY = std::clamp(int(std::floor((rect.bottom + rect.height - m_BucketBottom) / m_BucketSize)), 0, m_NumOfBucketsY - 1);
+}
+
+void DynamicHallways::AddToBuckets(int roomIdx, const Rectf& rect)
+{
+	int firstX{}, lastX{}, firstY{}, lastY{};
+	GetBuckets(rect, firstX, lastX, firstY, lastY);
+	for (int y{ firstY }; y <= lastY; ++y)
+	{
+		for (int x{ firstX }; x <= lastX; ++x)
+			m_Buckets[y * m_NumOfBucketsX + x].emplace_back(roomIdx);
+	}
+}
+
+void DynamicHallways::RemoveFromBuckets(int roomIdx, const Rectf& rect)
+{
+	int firstX{}, lastX{}, firstY{}, lastY{};
+	GetBuckets(rect, firstX, lastX, firstY, lastY);
+	for (int y{ firstY }; y <= lastY; ++y)
+	{
+		for (int x{ firstX }; x <= lastX; ++x)
+		{
+			std::vector<int>& bucket{ m_Buckets[y * m_NumOfBucketsX + x] };
+			bucket.erase(std::find(bucket.begin(), bucket.end(), roomIdx));
+		}
+	}
+}
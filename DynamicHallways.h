@@ -0,0 +1,94 @@
+#pragma once
+#include <vector>
+
+#include "Graph.h"
+#include "HallwayRouter.h"
+#include "Room.h"
+
+//The hallways of a dungeon that gets edited, kept per room connection so an edit only routes the connections it changed again.
+//Every connection gets the whole path it walks as hallways, so taking one out never takes away a corridor another one still walks.
+//Also counts the hallways that go through every room, which gives the deleted rooms that come back without checking every hallway.
+//Without a router every connection gets the straight hallways.
+class DynamicHallways final
+{
+public:
+	DynamicHallways() = default;
+
+	//Forgets every connection and puts the rooms in the buckets, for a router grid that was just made
+	void Begin(const RoomStore& rooms);
+
+	//Waits for ContinueRouting, a connection that is already there is left alone
+	void AddConnection(int roomA, int roomB);
+	//Called before a room gets moved, deleted or brought back, with the room still where the hallways were routed around it
+	void BeginRoomEdit(const RoomStore& rooms, int roomIdx);
+	//Takes out the connections the graph took out and puts the edited rooms on the grid where they are now.
+	//Their own connections wait to be routed again, as do the ones with a hallway through a room that is in the graph now.
+	//Returns false when an edited room does not fit on the grid, nothing was changed then and it has to start over with Begin
+	bool ApplyEdits(const RoomStore& rooms, const std::vector<Graph::ConnectionChange>& changes, HallwayRouter* pRouter);
+	//Routes up to the given number of waiting connections, returns true once none are left
+	bool ContinueRouting(const RoomStore& rooms, HallwayRouter* pRouter, int maxConnections, Pcg32& random);
+
+	void GetHallways(std::vector<Hallway>& hallways) const;
+	//Rooms with a hallway of a connection between two other rooms through them
+	void GetCrossedRooms(std::vector<int>& roomsOut);
+
+private:
+	static constexpr float m_BucketSize{ 128.f }; //Bigger than any room, so a room is in at most 4 buckets
+
+	//Every connection is in the lists of both of its rooms, next[i] continues the list of rooms[i]
+	struct RoutedConnection
+	{
+		int rooms[2]; //-1 when the connection was taken out
+		int next[2];
+		int firstHallway;
+		int numOfHallways;
+		bool isOnGrid; //The router made the hallways, so they are counted on its grid
+		bool isWaiting; //The hallways are not there yet
+	};
+
+	struct EditedRoom
+	{
+		int roomIdx;
+		Rectf rect; //Where it was when it was put in the buckets and on the grid
+	};
+
+	std::vector<RoutedConnection> m_Connections{};
+	std::vector<int> m_FreeConnections{};
+	std::vector<int> m_FirstConnections{}; //By room
+	std::vector<int> m_WaitingConnections{};
+	std::vector<Hallway> m_Hallways{}; //Every connection has a range, taken out connections leave gaps until the next compaction
+	int m_NumOfUsedHallways{};
+
+	std::vector<int> m_HallwayCounts{}; //By room, hallways of other rooms that go through the room
+	std::vector<int> m_CrossedRooms{}; //Rooms that got a hallway through them since the last GetCrossedRooms, and the ones before that still have one
+	std::vector<bool> m_IsCrossedRoomListed{};
+
+	std::vector<EditedRoom> m_EditedRooms{};
+	std::vector<bool> m_IsRoomEdited{};
+
+	//Rooms by the buckets their rect overlaps, outside of the buckets counts as the bucket on the edge
+	float m_BucketLeft{}, m_BucketBottom{};
+	int m_NumOfBucketsX{}, m_NumOfBucketsY{};
+	std::vector<std::vector<int>> m_Buckets{};
+	std::vector<int> m_RoomStamps{};
+	int m_CurrentStamp{};
+
+	//Scratch
+	std::vector<Hallway> m_Path{};
+	std::vector<Hallway> m_CompactedHallways{};
+	std::vector<int> m_ConnectionsToReroute{};
+
+	int FindConnection(int roomA, int roomB) const;
+	void RemoveConnection(int connectionIdx, const RoomStore& rooms, HallwayRouter* pRouter);
+	//Takes the hallways out and puts the connection in line to be routed again
+	void Reroute(int connectionIdx, const RoomStore& rooms, HallwayRouter* pRouter);
+	void ClearHallways(int connectionIdx, const RoomStore& rooms, HallwayRouter* pRouter);
+	//Adds the amount to the count of every room the hallway goes through, except for the rooms of its own connection
+	void CountHallway(const RoomStore& rooms, const Hallway& hallway, const int (&ownRooms)[2], int amount);
+	void AddToCount(int roomIdx, int amount);
+	void Compact();
+
+	void GetBuckets(const Rectf& rect, int& firstX, int& lastX, int& firstY, int& lastY) const;
+	void AddToBuckets(int roomIdx, const Rectf& rect);
+	void RemoveFromBuckets(int roomIdx, const Rectf& rect);
+};
@@ -0,0 +1,544 @@
+#include "DynamicSpanningTree.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace
+{
+	//Rooms, faces and glue are lighter than every edge, so they never come out as the heaviest on a path
+	constexpr DynamicSpanningTree::Edge g_NodeKey{ std::numeric_limits<float>::lowest(), -1, -1 };
+
+	//The tree of the faces looks for the lightest edge on a path, with everything negated that is the heaviest
+	DynamicSpanningTree::Edge Negate(const DynamicSpanningTree::Edge& edge)
+	{
+		return DynamicSpanningTree::Edge{ -edge.weight, -edge.roomA, -edge.roomB };
+	}
+}
+
+DynamicSpanningTree::DynamicSpanningTree()
+{
+	Clear();
+}
+
+void DynamicSpanningTree::Clear()
+{
+	m_Edges.clear();
+	m_FreeEdges.clear();
+	m_FirstEdges.clear();
+	m_Changes.clear();
+	m_Faces.clear();
+	m_FreeFaces.clear();
+	m_Nodes.clear();
+	m_FreeNodes.clear();
+	m_NodeByRoom.clear();
+
+	//The face outside of every triangle is always there
+	m_Faces.emplace_back(FaceRecord{ Face{ { -1, -1, -1 } }, CreateNode(g_NodeKey, -1) });
+}
+
+void DynamicSpanningTree::Update(const std::vector<Edge>& addedEdges, const std::vector<std::pair<int, int>>& removedEdges,
+	const std::vector<Face>& addedFaces, const std::vector<Face>& removedFaces)
+{
+	//The faces that go away are found through their edges, so look them up while those are all still there
+	m_RemovedFaces.clear();
+	for (const Face& face : removedFaces)
+	{
+		const int faceIdx{ FindFace(face) };
+		if (faceIdx != -1) m_RemovedFaces.emplace_back(faceIdx);
+	}
+
+	//Removing an edge joins the two faces next to it, those stay glued together until the new faces are in
+	m_Glues.clear();
+	for (const auto& rooms : removedEdges)
+	{
+		const int edgeIdx{ FindEdge(std::min(rooms.first, rooms.second), std::max(rooms.first, rooms.second)) };
+		if (edgeIdx != -1) DeleteEdge(edgeIdx);
+	}
+
+	//The new edges only go in the forest, the faces they split are not there yet
+	m_EdgesToLink.clear();
+	for (Edge edge : addedEdges)
+	{
+		if (edge.roomA == edge.roomB) continue;
+		if (edge.roomA > edge.roomB) std::swap(edge.roomA, edge.roomB);
+		AddRoom(edge.roomB);
+		if (FindEdge(edge.roomA, edge.roomB) != -1) continue;
+
+		const int edgeIdx{ AddEdgeRecord(edge) };
+		AddChange(edgeIdx, EdgeList::all, true);
+		InsertEdge(edgeIdx);
+		m_EdgesToLink.emplace_back(edgeIdx);
+	}
+
+	//Swap the old faces for the new ones. Every edge of a face that changed gets cut out of the tree of the faces
+	//and linked in again between its new faces, together with the new edges and the ones that left the forest
+	for (const Glue& glue : m_Glues)
+	{
+		Cut(glue.faceNodes[0], glue.node);
+		Cut(glue.node, glue.faceNodes[1]);
+		m_FreeNodes.emplace_back(glue.node);
+	}
+	for (const int faceIdx : m_RemovedFaces)
+		RemoveFace(faceIdx);
+	for (const Face& face : addedFaces)
+		AddFace(face);
+
+	for (const int edgeIdx : m_EdgesToLink)
+	{
+		const EdgeRecord& record{ m_Edges[edgeIdx] };
+		if (record.node == -1 && record.dualNode == -1) LinkDual(edgeIdx);
+	}
+}
+
+void DynamicSpanningTree::SetWeight(int roomA, int roomB, float weight)
+{
+	if (roomA > roomB) std::swap(roomA, roomB);
+	const int edgeIdx{ FindEdge(roomA, roomB) };
+	if (edgeIdx == -1 || m_Edges[edgeIdx].edge.weight == weight) return;
+
+	const Edge edge{ weight, roomA, roomB };
+	const bool isHeavier{ m_Edges[edgeIdx].edge < edge };
+	m_Edges[edgeIdx].edge = edge;
+
+	if (m_Edges[edgeIdx].node != -1)
+	{
+		SetNodeEdge(m_Edges[edgeIdx].node, edge, edgeIdx);
+		if (!isHeavier) return;
+
+		//A heavier edge of the forest makes way for a lighter other edge across it
+		const int replacementIdx{ FindLightestCrossingEdge(edgeIdx) };
+		if (replacementIdx == -1 || edge < m_Edges[replacementIdx].edge) return;
+
+		SplitForest(edgeIdx);
+		AddChange(edgeIdx, EdgeList::other, true);
+		CutDual(replacementIdx);
+		AddChange(replacementIdx, EdgeList::other, false);
+		JoinForest(replacementIdx);
+		LinkDual(edgeIdx);
+		return;
+	}
+
+	SetNodeEdge(m_Edges[edgeIdx].dualNode, Negate(edge), edgeIdx);
+	if (isHeavier) return;
+
+	//A lighter other edge takes the place of the heaviest edge on the path between its rooms
+	MakeRoot(m_NodeByRoom[roomA]);
+	Access(m_NodeByRoom[roomB]);
+	const int heaviestEdgeIdx{ m_Nodes[m_Nodes[m_NodeByRoom[roomB]].heaviestNode].edgeIdx };
+	if (heaviestEdgeIdx == -1 || m_Edges[heaviestEdgeIdx].edge < edge) return;
+
+	CutDual(edgeIdx);
+	AddChange(edgeIdx, EdgeList::other, false);
+	SplitForest(heaviestEdgeIdx);
+	AddChange(heaviestEdgeIdx, EdgeList::other, true);
+	JoinForest(edgeIdx);
+	LinkDual(heaviestEdgeIdx);
+}
+
+void DynamicSpanningTree::TakeChanges(std::vector<EdgeChange>& changes)
+{
+	//Swapping keeps the memory of both
+	changes.swap(m_Changes);
+	m_Changes.clear();
+}
+
+int DynamicSpanningTree::FindEdge(int roomA, int roomB) const
+{
+	if (roomA < 0 || roomB >= int(m_FirstEdges.size())) return -1;
+
+	for (int edgeIdx{ m_FirstEdges[roomA] }; edgeIdx != -1;)
+	{
+		const EdgeRecord& record{ m_Edges[edgeIdx] };
+		if (record.edge.roomA == roomA && record.edge.roomB == roomB) return edgeIdx;
+		edgeIdx = record.next[record.edge.roomA == roomA ? 0 : 1];
+	}
+	return -1;
+}
+
+int DynamicSpanningTree::AddEdgeRecord(const Edge& edge)
+{
+	int edgeIdx{};
+	if (!m_FreeEdges.empty())
+	{
+		edgeIdx = m_FreeEdges.back();
+		m_FreeEdges.pop_back();
+	}
+	else
+	{
+		edgeIdx = int(m_Edges.size());
+		m_Edges.emplace_back();
+	}
+
+	m_Edges[edgeIdx] = EdgeRecord{ edge, -1, -1, { m_OutsideFace, m_OutsideFace }, { m_FirstEdges[edge.roomA], m_FirstEdges[edge.roomB] } };
+	m_FirstEdges[edge.roomA] = edgeIdx;
+	m_FirstEdges[edge.roomB] = edgeIdx;
+	return edgeIdx;
+}
+
+void DynamicSpanningTree::RemoveEdgeRecord(int edgeIdx)
+{
+	const EdgeRecord& removed{ m_Edges[edgeIdx] };
+	const int rooms[2]{ removed.edge.roomA, removed.edge.roomB };
+	for (int i{}; i < 2; ++i)
+	{
+		//Find whatever points to the edge in the list of the room and skip over it
+		int* pLink{ &m_FirstEdges[rooms[i]] };
+		while (*pLink != edgeIdx)
+		{
+			EdgeRecord& record{ m_Edges[*pLink] };
+			pLink = &record.next[record.edge.roomA == rooms[i] ? 0 : 1];
+		}
+		*pLink = removed.next[i];
+	}
+	m_FreeEdges.emplace_back(edgeIdx);
+}
+
+void DynamicSpanningTree::AddRoom(int room)
+{
+	while (int(m_FirstEdges.size()) <= room)
+	{
+		m_FirstEdges.emplace_back(-1);
+		m_NodeByRoom.emplace_back(CreateNode(g_NodeKey, -1));
+	}
+}
+
+int DynamicSpanningTree::FindFace(const Face& face) const
+{
+	const int roomA{ face.rooms[0] }, roomB{ face.rooms[1] };
+	const int edgeIdx{ FindEdge(std::min(roomA, roomB), std::max(roomA, roomB)) };
+	if (edgeIdx == -1) return -1;
+
+	const int faceIdx{ m_Edges[edgeIdx].faces[roomA < roomB ? 0 : 1] };
+	return faceIdx == m_OutsideFace ? -1 : faceIdx;
+}
+
+int& DynamicSpanningTree::GetFaceSide(int roomA, int roomB)
+{
+	EdgeRecord& record{ m_Edges[FindEdge(std::min(roomA, roomB), std::max(roomA, roomB))] };
+	return record.faces[roomA < roomB ? 0 : 1];
+}
+
+void DynamicSpanningTree::RemoveFace(int faceIdx)
+{
+	const Face face{ m_Faces[faceIdx].face };
+	for (int i{}; i < 3; ++i)
+	{
+		//The edges that were removed already took their part of the tree of the faces with them
+		const int roomA{ face.rooms[i] }, roomB{ face.rooms[(i + 1) % 3] };
+		const int edgeIdx{ FindEdge(std::min(roomA, roomB), std::max(roomA, roomB)) };
+		if (edgeIdx == -1) continue;
+
+		if (m_Edges[edgeIdx].dualNode != -1)
+		{
+			CutDual(edgeIdx);
+			m_EdgesToLink.emplace_back(edgeIdx);
+		}
+		GetFaceSide(roomA, roomB) = m_OutsideFace;
+	}
+
+	m_FreeNodes.emplace_back(m_Faces[faceIdx].node);
+	m_FreeFaces.emplace_back(faceIdx);
+}
+
+void DynamicSpanningTree::AddFace(const Face& face)
+{
+	int faceIdx{};
+	if (!m_FreeFaces.empty())
+	{
+		faceIdx = m_FreeFaces.back();
+		m_FreeFaces.pop_back();
+	}
+	else
+	{
+		faceIdx = int(m_Faces.size());
+		m_Faces.emplace_back();
+	}
+	m_Faces[faceIdx] = FaceRecord{ face, CreateNode(g_NodeKey, -1) };
+
+	for (int i{}; i < 3; ++i)
+	{
+		//An edge that was next to the outside face before is still linked to it
+		const int roomA{ face.rooms[i] }, roomB{ face.rooms[(i + 1) % 3] };
+		const int edgeIdx{ FindEdge(std::min(roomA, roomB), std::max(roomA, roomB)) };
+		if (edgeIdx == -1) continue;
+
+		if (m_Edges[edgeIdx].dualNode != -1)
+		{
+			CutDual(edgeIdx);
+			m_EdgesToLink.emplace_back(edgeIdx);
+		}
+		GetFaceSide(roomA, roomB) = faceIdx;
+	}
+}
+
+void DynamicSpanningTree::InsertEdge(int edgeIdx)
+{
+	const Edge edge{ m_Edges[edgeIdx].edge };
+	const int nodeA{ m_NodeByRoom[edge.roomA] };
+	const int nodeB{ m_NodeByRoom[edge.roomB] };
+	if (FindRoot(nodeA) != FindRoot(nodeB))
+	{
+		JoinForest(edgeIdx);
+		return;
+	}
+
+	//The edge closes a cycle, whichever edge is the heaviest on it does not belong in the forest
+	MakeRoot(nodeA);
+	Access(nodeB);
+	const int heaviestEdgeIdx{ m_Nodes[m_Nodes[nodeB].heaviestNode].edgeIdx };
+	if (heaviestEdgeIdx == -1 || m_Edges[heaviestEdgeIdx].edge < edge)
+	{
+		AddChange(edgeIdx, EdgeList::other, true);
+		return;
+	}
+
+	SplitForest(heaviestEdgeIdx);
+	AddChange(heaviestEdgeIdx, EdgeList::other, true);
+	m_EdgesToLink.emplace_back(heaviestEdgeIdx);
+	JoinForest(edgeIdx);
+}
+
+void DynamicSpanningTree::DeleteEdge(int edgeIdx)
+{
+	EdgeRecord& record{ m_Edges[edgeIdx] };
+	const int faceNodes[2]{ m_Faces[record.faces[0]].node, m_Faces[record.faces[1]].node };
+
+	if (record.node == -1)
+	{
+		//The edge of the tree of the faces between them stays as the glue
+		AddChange(edgeIdx, EdgeList::other, false);
+		m_Glues.emplace_back(Glue{ record.dualNode, { faceNodes[0], faceNodes[1] } });
+		SetNodeEdge(record.dualNode, g_NodeKey, -1);
+		record.dualNode = -1;
+	}
+	else
+	{
+		SplitForest(edgeIdx);
+
+		//The lightest edge that joins the halves again is the one that crosses the path between the faces.
+		//Without one the faces already are glued together and the forest fell apart
+		const int replacementIdx{ FindLightestCrossingEdge(edgeIdx) };
+		if (replacementIdx != -1)
+		{
+			CutDual(replacementIdx);
+			AddChange(replacementIdx, EdgeList::other, false);
+			JoinForest(replacementIdx);
+
+			const int glueNode{ CreateNode(g_NodeKey, -1) };
+			Link(faceNodes[0], glueNode);
+			Link(glueNode, faceNodes[1]);
+			m_Glues.emplace_back(Glue{ glueNode, { faceNodes[0], faceNodes[1] } });
+		}
+	}
+
+	AddChange(edgeIdx, EdgeList::all, false);
+	RemoveEdgeRecord(edgeIdx);
+}
+
+int DynamicSpanningTree::FindLightestCrossingEdge(int edgeIdx)
+{
+	const EdgeRecord& record{ m_Edges[edgeIdx] };
+	if (record.faces[0] == record.faces[1]) return -1;
+
+	const int nodeA{ m_Faces[record.faces[0]].node };
+	const int nodeB{ m_Faces[record.faces[1]].node };
+	MakeRoot(nodeA);
+	Access(nodeB);
+	return m_Nodes[m_Nodes[nodeB].heaviestNode].edgeIdx;
+}
+
+void DynamicSpanningTree::JoinForest(int edgeIdx)
+{
+	const int node{ CreateNode(m_Edges[edgeIdx].edge, edgeIdx) };
+	EdgeRecord& record{ m_Edges[edgeIdx] };
+	record.node = node;
+	Link(m_NodeByRoom[record.edge.roomA], node);
+	Link(node, m_NodeByRoom[record.edge.roomB]);
+	AddChange(edgeIdx, EdgeList::tree, true);
+}
+
+void DynamicSpanningTree::SplitForest(int edgeIdx)
+{
+	EdgeRecord& record{ m_Edges[edgeIdx] };
+	Cut(m_NodeByRoom[record.edge.roomA], record.node);
+	Cut(record.node, m_NodeByRoom[record.edge.roomB]);
+	m_FreeNodes.emplace_back(record.node);
+	record.node = -1;
+	AddChange(edgeIdx, EdgeList::tree, false);
+}
+
+void DynamicSpanningTree::LinkDual(int edgeIdx)
+{
+	const int node{ CreateNode(Negate(m_Edges[edgeIdx].edge), edgeIdx) };
+	EdgeRecord& record{ m_Edges[edgeIdx] };
+	record.dualNode = node;
+	Link(m_Faces[record.faces[0]].node, node);
+	Link(node, m_Faces[record.faces[1]].node);
+}
+
+void DynamicSpanningTree::CutDual(int edgeIdx)
+{
+	EdgeRecord& record{ m_Edges[edgeIdx] };
+	Cut(m_Faces[record.faces[0]].node, record.dualNode);
+	Cut(record.dualNode, m_Faces[record.faces[1]].node);
+	m_FreeNodes.emplace_back(record.dualNode);
+	record.dualNode = -1;
+}
+
+void DynamicSpanningTree::SetNodeEdge(int node, const Edge& edge, int edgeIdx)
+{
+	//At the top of its splay tree nothing above it keeps the heaviest node of its subtree
+	Access(node);
+	m_Nodes[node].edge = edge;
+	m_Nodes[node].edgeIdx = edgeIdx;
+	Update(node);
+}
+
+int DynamicSpanningTree::CreateNode(const Edge& edge, int edgeIdx)
+{
+	int node{};
+	if (!m_FreeNodes.empty())
+	{
+		node = m_FreeNodes.back();
+		m_FreeNodes.pop_back();
+	}
+	else
+	{
+		node = int(m_Nodes.size());
+		m_Nodes.emplace_back();
+	}
+
+	m_Nodes[node] = Node{ { -1, -1 }, -1, node, false, edge, edgeIdx };
+	return node;
+}
+
+bool DynamicSpanningTree::IsSplayRoot(int node) const
+{
+	//The parent of a splay root is the node above its path, which does not have it as a child
+	const int parent{ m_Nodes[node].parent };
+	return parent == -1 || (m_Nodes[parent].children[0] != node && m_Nodes[parent].children[1] != node);
+}
+
+void DynamicSpanningTree::PushDown(int node)
+{
+	Node& current{ m_Nodes[node] };
+	if (!current.isReversed) return;
+
+	std::swap(current.children[0], current.children[1]);
+	for (const int child : current.children)
+	{
+		if (child != -1) m_Nodes[child].isReversed = !m_Nodes[child].isReversed;
+	}
+	current.isReversed = false;
+}
+
+void DynamicSpanningTree::Update(int node)
+{
+	Node& current{ m_Nodes[node] };
+	int heaviestNode{ node };
+	for (const int child : current.children)
+	{
+		if (child != -1 && m_Nodes[heaviestNode].edge < m_Nodes[m_Nodes[child].heaviestNode].edge)
+			heaviestNode = m_Nodes[child].heaviestNode;
+	}
+	current.heaviestNode = heaviestNode;
+}
+
+void DynamicSpanningTree::Rotate(int node)
+{
+	const int parent{ m_Nodes[node].parent };
+	const int grandParent{ m_Nodes[parent].parent };
+	const int side{ m_Nodes[parent].children[1] == node ? 1 : 0 };
+
+	if (!IsSplayRoot(parent))
+		m_Nodes[grandParent].children[m_Nodes[grandParent].children[1] == parent ? 1 : 0] = node;
+	m_Nodes[node].parent = grandParent;
+
+	const int child{ m_Nodes[node].children[1 - side] };
+	m_Nodes[parent].children[side] = child;
+	if (child != -1) m_Nodes[child].parent = parent;
+
+	m_Nodes[node].children[1 - side] = parent;
+	m_Nodes[parent].parent = node;
+
+	Update(parent);
+	Update(node);
+}
+
+void DynamicSpanningTree::Splay(int node)
+{
+	//Push the reversals down from the top first, so the rotations see the real children
+	m_Path.clear();
+	for (int current{ node };; current = m_Nodes[current].parent)
+	{
+		m_Path.emplace_back(current);
+		if (IsSplayRoot(current)) break;
+	}
+	for (int i{ int(m_Path.size()) - 1 }; i >= 0; --i)
+		PushDown(m_Path[i]);
+
+	while (!IsSplayRoot(node))
+	{
+		const int parent{ m_Nodes[node].parent };
+		if (!IsSplayRoot(parent))
+		{
+			const int grandParent{ m_Nodes[parent].parent };
+			const bool isSameSide{ (m_Nodes[grandParent].children[0] == parent) == (m_Nodes[parent].children[0] == node) };
+			Rotate(isSameSide ? parent : node);
+		}
+		Rotate(node);
+	}
+}
+
+void DynamicSpanningTree::Access(int node)
+{
+	//Makes the path from the root of the forest to the node one splay tree, with the node at its top
+	int last{ -1 };
+	for (int current{ node }; current != -1; current = m_Nodes[current].parent)
+	{
+		Splay(current);
+		m_Nodes[current].children[1] = last;
+		Update(current);
+		last = current;
+	}
+	Splay(node);
+}
+
+void DynamicSpanningTree::MakeRoot(int node)
+{
+	Access(node);
+	m_Nodes[node].isReversed = !m_Nodes[node].isReversed;
+}
+
+int DynamicSpanningTree::FindRoot(int node)
+{
+	Access(node);
+
+	int root{ node };
+	while (true)
+	{
+		PushDown(root);
+		if (m_Nodes[root].children[0] == -1) break;
+		root = m_Nodes[root].children[0];
+	}
+	Splay(root);
+	return root;
+}
+
+void DynamicSpanningTree::Link(int nodeA, int nodeB)
+{
+	MakeRoot(nodeA);
+	m_Nodes[nodeA].parent = nodeB;
+}
+
+void DynamicSpanningTree::Cut(int nodeA, int nodeB)
+{
+	MakeRoot(nodeA);
+	Access(nodeB);
+
+	//nodeA is right above nodeB, so it is all that is left of nodeB's splay tree
+	m_Nodes[nodeB].children[0] = -1;
+	m_Nodes[nodeA].parent = -1;
+	Update(nodeB);
+}
@@ -0,0 +1,161 @@
+#pragma once
+#include <utility>
+#include <vector>
+
+//Minimum spanning forest of a triangulation that changes a few triangles at a time, so editing a dungeon does not have to redo Kruskal.
+//The forest is kept in a link-cut tree, which finds the heaviest edge on the path between two rooms in logarithmic time:
+//a new edge that is lighter than that one takes its place.
+//The triangulation is a planar graph, so the edges that are not in the forest form a spanning tree of the faces, with an edge
+//of that tree crossing every one of them. It is kept in the same link-cut tree, and cutting a forest edge splits the forest
+//in two halves whose other edges are exactly the ones on the path between the two faces of the cut edge.
+//The lightest of those joins the halves again, so removing an edge costs logarithmic time as well instead of a search through a half.
+//Only the triangles between three rooms are faces, everything outside of them counts as one face.
+//Edges are ordered on weight and then on their rooms, so there is only one minimum spanning forest
+//and it is the same one Kruskal finds with that order.
+//Instead of handing out every edge, it keeps track of which edges joined or left the forest and the other edges,
+//so whoever keeps the edges in lists only has to patch those.
+class DynamicSpanningTree final
+{
+public:
+	struct Edge
+	{
+		float weight;
+		int roomA; //The lowest of the two
+		int roomB;
+
+		bool operator<(const Edge& other) const
+		{
+			if (weight != other.weight) return weight < other.weight;
+			if (roomA != other.roomA) return roomA < other.roomA;
+			return roomB < other.roomB;
+		}
+	};
+
+	//A triangle of the triangulation, its rooms go counter clockwise
+	struct Face
+	{
+		int rooms[3];
+	};
+
+	enum class EdgeList
+	{
+		tree, //The edges of the forest
+		other, //The edges that are not in the forest
+		all
+	};
+
+	struct EdgeChange
+	{
+		Edge edge;
+		int edgeIdx; //Stays the same while the edge is there, a removed edge gives its index to the next new one
+		EdgeList list;
+		bool isAdded;
+	};
+
+	DynamicSpanningTree();
+
+	void Clear();
+
+	//Applies everything one edit of the triangulation added and removed at once, the rooms of the edges can be in any order.
+	//Edges that stayed but changed weight go through SetWeight afterwards
+	void Update(const std::vector<Edge>& addedEdges, const std::vector<std::pair<int, int>>& removedEdges,
+		const std::vector<Face>& addedFaces, const std::vector<Face>& removedFaces);
+	void SetWeight(int roomA, int roomB, float weight);
+
+	//Index of the edge between the rooms, -1 when there is none. Takes time in the number of edges of the rooms
+	int FindEdge(int roomA, int roomB) const;
+	bool IsTreeEdge(int edgeIdx) const { return m_Edges[edgeIdx].node != -1; }
+
+	//Fills in what changed since the last call or the last Clear in the order it happened, and starts over.
+	//An edge always leaves a list before it joins another one, so the changes can be applied one by one
+	void TakeChanges(std::vector<EdgeChange>& changes);
+
+private:
+	static constexpr int m_OutsideFace{ 0 };
+
+	//Every edge is in the lists of both of its rooms, next[i] continues the list of room i of the edge
+	struct EdgeRecord
+	{
+		Edge edge;
+		int node; //Node in the forest while the edge is part of it, -1 otherwise
+		int dualNode; //Node in the tree of the faces while the edge is not part of the forest, -1 otherwise
+		int faces[2]; //faces[0] is on the left going from roomA to roomB
+		int next[2];
+	};
+
+	struct FaceRecord
+	{
+		Face face;
+		int node;
+	};
+
+	//An edge between two faces that was removed, the faces count as one until the edit is done
+	struct Glue
+	{
+		int node;
+		int faceNodes[2];
+	};
+
+	//Nodes of the link-cut tree are rooms, faces and edges. Every node is in a splay tree that holds one path
+	//of its tree, ordered from the root of the tree down. The root of a splay tree points to the node above the path.
+	//The forest and the tree of the faces share the nodes, but no edge ever links one to the other
+	struct Node
+	{
+		int children[2];
+		int parent;
+		int heaviestNode; //Heaviest node in this splay subtree
+		bool isReversed;
+		Edge edge; //Rooms and faces are lighter than every edge. In the tree of the faces edges get their weight and rooms negated, so the heaviest is the lightest edge
+		int edgeIdx; //-1 for rooms, faces and glue
+	};
+
+	std::vector<EdgeRecord> m_Edges{};
+	std::vector<int> m_FreeEdges{};
+	std::vector<int> m_FirstEdges{}; //By room
+	std::vector<EdgeChange> m_Changes{};
+
+	std::vector<FaceRecord> m_Faces{};
+	std::vector<int> m_FreeFaces{};
+
+	std::vector<Node> m_Nodes{};
+	std::vector<int> m_FreeNodes{};
+	std::vector<int> m_NodeByRoom{};
+
+	//Scratch for splaying and for an update
+	std::vector<int> m_Path{};
+	std::vector<int> m_RemovedFaces{};
+	std::vector<Glue> m_Glues{};
+	std::vector<int> m_EdgesToLink{};
+
+	int AddEdgeRecord(const Edge& edge);
+	void RemoveEdgeRecord(int edgeIdx);
+	void AddRoom(int room);
+	void AddChange(int edgeIdx, EdgeList list, bool isAdded) { m_Changes.emplace_back(EdgeChange{ m_Edges[edgeIdx].edge, edgeIdx, list, isAdded }); }
+
+	int FindFace(const Face& face) const;
+	int& GetFaceSide(int roomA, int roomB);
+	void RemoveFace(int faceIdx);
+	void AddFace(const Face& face);
+
+	void InsertEdge(int edgeIdx);
+	void DeleteEdge(int edgeIdx);
+	int FindLightestCrossingEdge(int edgeIdx);
+	void JoinForest(int edgeIdx);
+	void SplitForest(int edgeIdx);
+	void LinkDual(int edgeIdx);
+	void CutDual(int edgeIdx);
+	void SetNodeEdge(int node, const Edge& edge, int edgeIdx);
+
+	//Link-cut tree
+	int CreateNode(const Edge& edge, int edgeIdx);
+	bool IsSplayRoot(int node) const;
+	void PushDown(int node);
+	void Update(int node);
+	void Rotate(int node);
+	void Splay(int node);
+	void Access(int node);
+	void MakeRoot(int node);
+	int FindRoot(int node);
+	void Link(int nodeA, int nodeB);
+	void Cut(int nodeA, int nodeB);
+};
@@ -1,10 +1,12 @@
 #include "pch.h"
 
 //External Includes
-#include "Room.h"
 #include "Camera.h"
-#include "Graph.h"
-#include "Texture.h"
+#include "DungeonMesh.h"
+#include "DungeonPrefetcher.h"
+#include "DungeonQuadtree.h"
+#include "ResourceManager.h"
+#include "TextRenderer.h"
 
 #include "Game.h"
 
@@ -27,44 +29,40 @@ Game::~Game()
 
 void Game::Initialize()
 {
-	//Pre-Allocate memory for the rooms
-	m_Rooms.reserve(m_NumOfRoomsToGen);
+	//Start generating the first dungeons in the background
+	m_pPrefetcher = new DungeonPrefetcher(CreateDungeonParams(), m_PrefetchDepth);
+	m_pEditor = new DungeonGenerator();
 
-	//Initialize all the rooms and add them to the array
-	for (int i{}; i < m_NumOfRoomsToGen; ++i)
-		m_Rooms.emplace_back(new Room(m_Window.width, m_Window.height, i));
+	m_pTextRenderer = new TextRenderer();
+	m_pResourceManager = new ResourceManager();
+	m_pQuadtree = new DungeonQuadtree();
+	m_pDungeonMesh = new DungeonMesh(*m_pResourceManager, *m_pQuadtree);
 
-	//Sort the rooms from smallest to largest
-	std::sort(m_Rooms.begin(), m_Rooms.end(), Room::CompareRoomSize);
-
-	//Initialize the camera
+	//Initialize the camera, the level boundaries are set for every dungeon that comes in
 	m_pCamera = new Camera(m_Window.width, m_Window.height);
-	m_pCamera->SetLevelBoundaries(Rectf{ -m_Window.width / 2.f, -m_Window.height / 2.f, m_Window.width / 2.f, m_Window.height / 1.5f});
-
-	//Initialize the graph
-	m_pGraph = new Graph();
+	m_pCamera->SetZoom(m_ZoomIn);
 
 	PrintControls();
 }
 
 void Game::Cleanup()
 {
-	for (const auto& room : m_Rooms)
-		delete room;
-	for (const auto& room : m_DeletedRooms)
-		delete room;
 	delete m_pCamera;
-	delete m_pGraph;
+	delete m_pPrefetcher;
+	delete m_pEditor;
+	delete m_pTextRenderer;
+	delete m_pDungeonMesh;
+	delete m_pQuadtree;
+	delete m_pResourceManager;
 }
 
 void Game::Update(float elapsedSec)
 {
 
 	HandleDungeonGeneration();
+	UpdateEditing();
 	HandleInput();
-
-	for (const auto& room : m_Rooms)
-		room->Update(); //Update the rooms
+	m_pResourceManager->Update();
 
 	UpdateTimer(elapsedSec);
 	m_pCamera->Clamp(m_CameraPosition);
@@ -74,13 +72,14 @@ void Game::Draw() const
 {
 	ClearBackground();
 
-	//If still generating the old dungeon
-	if (m_CurrentStage != done)
+	//If still waiting for the next dungeon
+	if (!m_pDungeon)
 	{
-		const Texture generatingTexture{ "Generating Dungeon...","Fonts/dogica.ttf" ,30, Color4f{1,1,1,1} };
-		generatingTexture.Draw(Rectf{ m_Window.width / 2.f - generatingTexture.GetWidth() / 2.f, 
-			m_Window.height / 2.f - generatingTexture.GetHeight() / 2.f,
-			generatingTexture.GetWidth(), generatingTexture.GetHeight() });
+		const std::string generatingText{ "Generating Dungeon..." };
+		const Point2f generatingSize{ m_pTextRenderer->MeasureText(generatingText, m_FontPath, 30) };
+		m_pTextRenderer->QueueText(generatingText, m_FontPath, 30, Point2f{ m_Window.width / 2.f - generatingSize.x / 2.f,
+			m_Window.height / 2.f - generatingSize.y / 2.f }, Color4f{ 1,1,1,1 });
+		m_pTextRenderer->Flush();
 		return;
 	}
 
@@ -90,40 +89,16 @@ void Game::Draw() const
 		//Update camera canvas
 		m_pCamera->Transform(m_CameraPosition);
 
-		
 
-		for (const auto& hallway : m_Hallways)
-		{
-			utils::SetColor(Color4f{ 76.1f, 69.8f, 50.2f ,1.0f });
-			utils::DrawLine(hallway.startingPoint, hallway.endPoint, float(hallway.hallwaySize));
-		}
-
-		for (const auto& room : m_Rooms)
-			room->Draw();
+		//The dungeon does not change once it is generated, it was baked into the mesh when it came in
+		m_pDungeonMesh->Draw(m_pCamera->GetViewRect(), m_ZoomIn);
+		DrawRoomHighlights();
 
 		if (m_DoDebug)
-		{
-			for (const auto& room : m_DeletedRooms)
-			{
-				utils::SetColor(Color4f{0,0.5f,0.5f,1});
-				utils::DrawRect(room->GetRect());
-			}
-
-			m_pGraph->DebugDraw();
-			for (const auto& room : m_Rooms)
-			{
-				const Texture roomID("ID:" + std::to_string(room->GetId()), "Fonts/dogica.ttf", 7, Color4f{1,1,1,1});
-				roomID.Draw(Rectf{ room->GetRect().left, room->GetRect().bottom, roomID.GetWidth(), roomID.GetHeight() });
-
-				const Texture roomX("X:" + std::to_string(int(std::round(room->GetPosition().x))), "Fonts/dogica.ttf", 8, Color4f{ 1,1,1,1 });
-				roomX.Draw(Rectf{ room->GetRect().left, room->GetRect().bottom + room->GetRect().height - roomX.GetHeight()
-					,roomX.GetWidth(), roomX.GetHeight() });
-
-				const Texture roomY("Y:" + std::to_string(int(std::round(room->GetPosition().y))), "Fonts/dogica.ttf", 8, Color4f{ 1,1,1,1 });
-				roomY.Draw(Rectf{ room->GetRect().left, room->GetRect().bottom + room->GetRect().height - 3 * roomY.GetHeight()
-					,roomY.GetWidth(), roomY.GetHeight() });
-			}
-		}
+			DrawDebug();
+
+		//The batched shapes use the camera transform, draw them before it gets popped
+		utils::FlushDrawBatch();
 	}
 	glPopMatrix();
 
@@ -135,45 +110,201 @@ void Game::DrawUI() const
 	//Draw timer
 	std::stringstream stream{};
 	stream << std::fixed << std::setprecision(1) << m_MaxDisplayTime - m_CurrentDisplayTime;
-	const Texture timerTexture{ "Next Room In:" + stream.str() , "Fonts/dogica.ttf", 25, Color4f{1,1,1,1} };
+	const std::string timerText{ "Next Room In:" + stream.str() };
+	const Point2f timerSize{ m_pTextRenderer->MeasureText(timerText, m_FontPath, 25) };
 	constexpr float windowGap{ 10 };
-	timerTexture.Draw(Rectf{ m_Window.width - timerTexture.GetWidth() - windowGap, m_Window.height - timerTexture.GetHeight() - windowGap,
-		timerTexture.GetWidth(), timerTexture.GetHeight() });
+	m_pTextRenderer->QueueText(timerText, m_FontPath, 25, Point2f{ m_Window.width - timerSize.x - windowGap, m_Window.height - timerSize.y - windowGap },
+		Color4f{ 1,1,1,1 });
 
 	//Draw number of rooms
-	const Texture roomCounterTexture{ "Minimum Number Of Rooms:" + std::to_string(m_MinimumNumOfRooms),"Fonts/dogica.ttf" ,10, Color4f{1,1,1,1} };
-	roomCounterTexture.Draw(Point2f{ windowGap, m_Window.height - roomCounterTexture.GetHeight() - windowGap });
+	const std::string roomCounterText{ "Minimum Number Of Rooms:" + std::to_string(m_MinimumNumOfRooms) };
+	const Point2f roomCounterSize{ m_pTextRenderer->MeasureText(roomCounterText, m_FontPath, 10) };
+	m_pTextRenderer->QueueText(roomCounterText, m_FontPath, 10, Point2f{ windowGap, m_Window.height - roomCounterSize.y - windowGap },
+		Color4f{ 1,1,1,1 });
+
+	//Draw the selected room
+	if (m_SelectedRoomIdx != -1)
+	{
+		const RoomStore& rooms{ m_pDungeon->rooms };
+		const Rectf rect{ rooms.GetRect(m_SelectedRoomIdx) };
+		const std::string selectedText{ "Selected Room ID:" + std::to_string(rooms.GetId(m_SelectedRoomIdx)) +
+			" Size:" + std::to_string(int(rect.width)) + "x" + std::to_string(int(rect.height)) };
+		m_pTextRenderer->QueueText(selectedText, m_FontPath, 10, Point2f{ windowGap, windowGap }, Color4f{ 1,1,1,1 });
+	}
+
+	m_pTextRenderer->Flush();
+}
+
+void Game::DrawRoomHighlights() const
+{
+	const RoomStore& rooms{ m_pDungeon->rooms };
+	if (m_HoveredRoomIdx != -1 && m_HoveredRoomIdx != m_SelectedRoomIdx)
+	{
+		utils::SetColor(Color4f{ 1,1,0,1 });
+		utils::DrawRect(rooms.GetRect(m_HoveredRoomIdx), 2.f);
+	}
+	if (m_SelectedRoomIdx != -1)
+	{
+		utils::SetColor(Color4f{ 1,0.5f,0,1 });
+		utils::DrawRect(rooms.GetRect(m_SelectedRoomIdx), 3.f);
+	}
+}
+
+void Game::DrawDebug() const
+{
+	const DungeonResult& dungeon{ *m_pDungeon };
+
+	const RoomStore& rooms{ dungeon.rooms };
+	for (int roomIdx{}; roomIdx < rooms.GetSize(); ++roomIdx)
+	{
+		if (rooms.IsAlive(roomIdx)) continue;
+
+		utils::SetColor(Color4f{0,0.5f,0.5f,1});
+		utils::DrawRect(rooms.GetRect(roomIdx));
+	}
+
+	//Draw the graph the hallways were made from
+	utils::SetColor(Color4f{ 0,1,0,1 });
+	for (const auto& edge : dungeon.delaunayEdges)
+		utils::DrawLine(edge.start.x, edge.start.y, edge.end.x, edge.end.y);
+
+	for (int roomIdx{}; roomIdx < rooms.GetSize(); ++roomIdx)
+	{
+		if (rooms.IsAlive(roomIdx))
+			utils::DrawEllipse(rooms.GetCenter(roomIdx), 5, 5);
+	}
+
+	for (const auto& edge : dungeon.delaunayEdges)
+	{
+		m_pTextRenderer->QueueText("W:" + std::to_string(int(std::round(edge.weight))), m_FontPath, 7,
+			Point2f{ (edge.start.x + edge.end.x) / 2.f, (edge.start.y + edge.end.y) / 2.f }, Color4f{ 1,1,1,1 });
+	}
+
+	utils::SetColor(Color4f{ 0,0,1,1 });
+	for (const auto& edge : dungeon.mstEdges)
+		utils::DrawLine(edge.start.x, edge.start.y, edge.end.x, edge.end.y);
+
+	utils::SetColor(Color4f{ 1,1,1,1 });
+	for (const auto& edge : dungeon.deletedEdges)
+		utils::DrawLine(edge.start.x, edge.start.y, edge.end.x, edge.end.y);
+
+	utils::SetColor(Color4f{ 1,0,0,1 });
+	for (const auto& edge : dungeon.roomConnections)
+		utils::DrawLine(edge.start.x, edge.start.y, edge.end.x, edge.end.y);
+
+	for (int roomIdx{}; roomIdx < rooms.GetSize(); ++roomIdx)
+	{
+		if (!rooms.IsAlive(roomIdx)) continue;
+		const Rectf rect{ rooms.GetRect(roomIdx) };
+		const Point2f center{ rooms.GetCenter(roomIdx) };
+
+		m_pTextRenderer->QueueText("ID:" + std::to_string(rooms.GetId(roomIdx)), m_FontPath, 7, Point2f{ rect.left, rect.bottom }, Color4f{ 1,1,1,1 });
+
+		const std::string roomX{ "X:" + std::to_string(int(std::round(center.x))) };
+		const float roomXHeight{ m_pTextRenderer->MeasureText(roomX, m_FontPath, 8).y };
+		m_pTextRenderer->QueueText(roomX, m_FontPath, 8, Point2f{ rect.left, rect.bottom + rect.height - roomXHeight }, Color4f{ 1,1,1,1 });
+
+		const std::string roomY{ "Y:" + std::to_string(int(std::round(center.y))) };
+		const float roomYHeight{ m_pTextRenderer->MeasureText(roomY, m_FontPath, 8).y };
+		m_pTextRenderer->QueueText(roomY, m_FontPath, 8, Point2f{ rect.left, rect.bottom + rect.height - 3 * roomYHeight }, Color4f{ 1,1,1,1 });
+	}
+
+	//The labels use the camera transform, so they have to be drawn before it gets popped
+	m_pTextRenderer->Flush();
+}
+
+DungeonParams Game::CreateDungeonParams() const
+{
+	DungeonParams params{};
+	params.minimumNumOfRooms = m_MinimumNumOfRooms;
+	params.roomTightness = m_RoomTightness;
+	params.spawnWidth = m_Window.width;
+	params.spawnHeight = m_Window.height;
+	params.seed = unsigned(rand()); //main seeds rand() with the time so every run is different
+
+	return params;
+}
+
+void Game::UpdateDungeonParams()
+{
+	//The dungeons that were already generated ahead use the old parameters, the prefetcher throws those away
+	m_pPrefetcher->SetParams(CreateDungeonParams());
 }
 
 void Game::ResetDungeon()
 {
-	for (const auto& room : m_Rooms)
-		delete room;
-	for (const auto& room : m_DeletedRooms)
-		delete room;
+	//Swaps straight to the next dungeon when it is already generated, otherwise waits for it in HandleDungeonGeneration
+	m_pDungeon = m_pPrefetcher->TryGetDungeon(m_GenerationBudgetMs);
+	m_IsEditingDungeon = false;
+	m_IsNumOfRoomsEdited = false;
+	m_DraggedRoomIdx = -1;
+	m_DragOffset = Vector2f{};
+	m_HoveredRoomIdx = -1;
+	m_SelectedRoomIdx = -1;
+	m_IsDraggingRoom = false;
+	if (!m_pDungeon) return;
+
+	ShowDungeon();
+}
 
-	m_Rooms.clear();
-	m_DeletedRooms.clear();
-	m_Hallways.clear();
-	m_pGraph->Reset();
+void Game::ShowDungeon()
+{
+	m_pQuadtree->Build(*m_pDungeon);
+	m_pDungeonMesh->Build(*m_pDungeon);
 
-	//Re-Calculate this as the user might change it
-	m_NumOfRoomsToGen = { m_MinimumNumOfRooms * 2 };
+	const Rectf& bounds{ m_pQuadtree->GetBounds() };
+	m_pCamera->SetLevelBoundaries(Rectf{ bounds.left - m_LevelMargin, bounds.bottom - m_LevelMargin,
+		bounds.width + 2 * m_LevelMargin, bounds.height + 2 * m_LevelMargin });
+}
 
-	//Pre-Allocate memory for the rooms
-	m_Rooms.reserve(m_NumOfRoomsToGen);
+bool Game::BeginEditing()
+{
+	if (m_IsEditingDungeon) return true;
+	const DungeonParams* pParams{ m_pPrefetcher->GetParamsOnScreen() };
+	if (!m_pDungeon || !pParams) return false;
+
+	//The prefetcher does not keep the generator of the dungeon on screen, every dungeon only depends on its parameters
+	//so the editor makes the same one again, spread out over the frames by UpdateEditing. After that the edits only redo what they change
+	m_pEditor->Reset(*pParams);
+	m_IsEditingDungeon = true;
+	return true;
+}
+
+void Game::UpdateEditing()
+{
+	if (!m_IsEditingDungeon) return;
+
+	//Everything that came in while the editor was busy goes in at once
+	if (m_pEditor->IsDone())
+	{
+		const bool isDragged{ m_DraggedRoomIdx != -1 && (m_DragOffset.x != 0.f || m_DragOffset.y != 0.f) };
+		if (!m_IsNumOfRoomsEdited && !isDragged) return;
+
+		if (m_IsNumOfRoomsEdited) m_pEditor->SetMinimumNumOfRooms(m_MinimumNumOfRooms);
+		if (isDragged) m_pEditor->MoveRoom(m_DraggedRoomIdx, m_DragOffset.x, m_DragOffset.y);
+		m_IsNumOfRoomsEdited = false;
+		m_DraggedRoomIdx = -1;
+		m_DragOffset = Vector2f{};
+	}
 
-	//Initialize all the rooms and add them to the array
-	for (int i{}; i < m_NumOfRoomsToGen; ++i)
-		m_Rooms.emplace_back(new Room(m_Window.width, m_Window.height, i));
+	//The mesh and the quadtree only get rebuilt for a finished dungeon
+	if (m_pEditor->Advance(m_GenerationBudgetMs))
+	{
+		m_pDungeon = &m_pEditor->GetResult();
+		ShowDungeon();
+	}
+}
 
-	m_CurrentStage = Game::CurrentStage::roomSeparation;
+void Game::SetZoom(float zoom)
+{
+	m_ZoomIn = std::max(zoom, m_MinZoom);
+	m_pCamera->SetZoom(m_ZoomIn);
 }
 
 void Game::UpdateTimer(float elapsedSec)
 {
 	//Update Timer
-	if (!m_IsTimerPaused && m_CurrentStage == done)
+	if (!m_IsTimerPaused && m_pDungeon)
 		m_CurrentDisplayTime += elapsedSec;
 
 	if (m_CurrentDisplayTime >= m_MaxDisplayTime)
@@ -185,80 +316,9 @@ void Game::UpdateTimer(float elapsedSec)
 
 void Game::HandleDungeonGeneration()
 {
-	switch (m_CurrentStage)
-	{
-		//Step 1: Separate the rooms
-	case Game::roomSeparation:
-	{
-		float tightnessChecked{ m_RoomTightness };
-		if (tightnessChecked < 1.f) tightnessChecked = 1;
-		if (tightnessChecked > 3.f) tightnessChecked = 3;
-
-		Room::SeparateRooms(m_Rooms, tightnessChecked);
-		if (!Room::AreRoomsOverlapping(m_Rooms)) m_CurrentStage = Game::CurrentStage::roomDeletion;
-	}
-	break;
-	//Step 2: Delete all the secondary rooms
-	case Game::roomDeletion:
-	{
-		for (int i{ m_NumOfRoomsToGen }; i > m_MinimumNumOfRooms; --i)
-		{
-			m_DeletedRooms.emplace_back(m_Rooms[i - 1]);
-			m_Rooms.pop_back();
-		}
-		std::vector<Vertex> points{};
-		for (const auto& room : m_Rooms)
-			points.emplace_back(room->GetPosition(), room->GetId());
-
-		m_pGraph->SetPoints(points);
-	}
-	m_CurrentStage = Game::CurrentStage::delaunyTriangulation;
-	break;
-	//Step 3: Calculate the Delauny Triangulation
-	case Game::delaunyTriangulation:
-		m_pGraph->CalculateTriangulation();
-		m_CurrentStage = Game::CurrentStage::MST;
-		break;
-		//Step 4: Find the minimum spanning tree for the triangulation
-	case Game::MST:
-		m_pGraph->CalculateMST();
-		m_CurrentStage = Game::CurrentStage::roomConnections;
-		break;
-		//Step 5: Randomly add deleted edges to add variation and cycles to the dungeon
-	case Game::roomConnections:
-		m_pGraph->FillRoomConnections();
-		m_CurrentStage = Game::CurrentStage::addingHallways;
-		break;
-		//Step 6: Connect the rooms based on the room connections formed from the previous steps
-	case Game::addingHallways:
-		CreateHallways();
-		m_CurrentStage = Game::CurrentStage::addDeletedRooms;
-		break;
-	case Game::addDeletedRooms:
-		for (const auto& hallway : m_Hallways)
-		{
-			float minFlt{}, maxFlt{};
-			for (auto it = m_DeletedRooms.begin(); it != m_DeletedRooms.end();)
-			{
-				auto& room = *it;
-				if (utils::IntersectRectLine(room->GetRect(), hallway.startingPoint, hallway.endPoint, minFlt, maxFlt))
-				{
-					m_Rooms.emplace_back(std::move(room));
-					it = m_DeletedRooms.erase(it);
-				}
-				else
-				{
-					++it;
-				}
-			}
-		}
-		m_CurrentStage = Game::CurrentStage::done;
-
-		std::sort(m_Rooms.begin(), m_Rooms.end(), Room::CompareRoomSize);
-		//Add any special rooms here:
-		m_Rooms.back()->SetSpecialRoom(Room::SpecialRoomTypes::BOSS);
-		break;
-	}
+	//The generation itself happens on the prefetcher's worker thread
+	if (!m_pDungeon)
+		ResetDungeon();
 }
 
 void Game::HandleInput()
@@ -283,13 +343,15 @@ void Game::ProcessKeyDownEvent(const SDL_KeyboardEvent& e)
 		m_IsTimerPaused = !m_IsTimerPaused;
 	}
 
-	if (e.keysym.sym == SDLK_k)
-	{
-		++m_MinimumNumOfRooms;
-	}
-	if (e.keysym.sym == SDLK_j)
+	//The dungeon on screen gets edited, the next ones are generated with the new number from the start
+	if (e.keysym.sym == SDLK_k || e.keysym.sym == SDLK_j)
 	{
-		if (--m_MinimumNumOfRooms < 3) m_MinimumNumOfRooms = 3;
+		if (e.keysym.sym == SDLK_k) ++m_MinimumNumOfRooms;
+		else if (--m_MinimumNumOfRooms < 3) m_MinimumNumOfRooms = 3;
+		UpdateDungeonParams();
+
+		if (BeginEditing())
+			m_IsNumOfRoomsEdited = true;
 	}
 }
 
@@ -299,23 +361,41 @@ void Game::ProcessKeyUpEvent(const SDL_KeyboardEvent& e)
 }
 void Game::ProcessMouseMotionEvent(const SDL_MouseMotionEvent& e)
 {
-	
+	if (!m_pDungeon) return;
+	const Point2f mousePosition{ m_pCamera->ScreenToWorld(Point2f{ float(e.x), float(e.y) }) };
+
+	//The offset piles up until the next frame the editor is done. Only one room can wait at a time,
+	//dragging another one keeps m_DragPosition so it gets the whole offset once the first one is in
+	if (m_IsDraggingRoom && BeginEditing() && (m_DraggedRoomIdx == -1 || m_DraggedRoomIdx == m_SelectedRoomIdx))
+	{
+		m_DragOffset += Vector2f{ m_DragPosition, mousePosition };
+		m_DraggedRoomIdx = m_SelectedRoomIdx;
+		m_DragPosition = mousePosition;
+	}
+
+	m_HoveredRoomIdx = m_pQuadtree->PickRoom(mousePosition);
 }
 void Game::ProcessMouseDownEvent(const SDL_MouseButtonEvent& e)
 {
-	
+	if (!m_pDungeon || e.button != SDL_BUTTON_LEFT) return;
+
+	//Clicking next to the rooms clears the selection, holding the button on a room drags it around
+	m_DragPosition = m_pCamera->ScreenToWorld(Point2f{ float(e.x), float(e.y) });
+	m_SelectedRoomIdx = m_pQuadtree->PickRoom(m_DragPosition);
+	m_IsDraggingRoom = m_SelectedRoomIdx != -1;
 }
 void Game::ProcessMouseUpEvent(const SDL_MouseButtonEvent& e)
 {
-	
+	if (e.button == SDL_BUTTON_LEFT)
+		m_IsDraggingRoom = false;
 }
 void Game::ProcessScrollUpEvent(const SDL_MouseWheelEvent& e)
 {
-	m_ZoomIn += 0.05f;
+	SetZoom(m_ZoomIn + 0.05f);
 }
 void Game::ProcessScrollDownEvent(const SDL_MouseWheelEvent& e)
 {
-	m_ZoomIn -= 0.05f;
+	SetZoom(m_ZoomIn - 0.05f);
 }
 
 void Game::ClearBackground() const
@@ -324,32 +404,13 @@ void Game::ClearBackground() const
 	glClear(GL_COLOR_BUFFER_BIT);
 }
 
-void Game::CreateHallways()
-{
-	std::vector<Connection> MSTEdges{ m_pGraph->GetRoomConnections() };
-	Room room1{}, room2{};
-	auto VertexToRoom = [&](const Vertex& vertex, const std::vector<Room*> rooms) ->Room
-	{
-		for (const auto& room : rooms)
-		{
-			if (vertex.roomConnectionID == room->GetId()) return *room;
-		}
-
-		return Room{};
-	};
-
-	for (const auto& edge : MSTEdges)
-	{
-		Room::ConnectRooms(VertexToRoom(edge.start, m_Rooms), VertexToRoom(edge.end, m_Rooms), m_Hallways);
-	}
-}
-
 void Game::PrintControls() const 
 {
 	std::cout << "\033[1;33m=================\033[1;31mCONTROLS\033[1;33m================\033[0m" << std::endl;
 	std::cout << "Use \033[1;31mSPACE\033[0m to \033[1;32mPause\033[0m the timer" << std::endl;
 	std::cout << "Use the \033[1;31mArrow Keys\033[0m to \033[1;32mMove\033[0m around" << std::endl;
 	std::cout << "Use the \033[1;31mScroll Wheel\033[0m to \033[1;32mZoom In/Out\033[0m" << std::endl;
+	std::cout << "Use the \033[1;31mLeft Mouse Button\033[0m to \033[1;32mSelect\033[0m and \033[1;32mDrag\033[0m a room" << std::endl;
 	std::cout << "Use \033[1;31mJ/K\033[0m to \033[1;32mDecrease/Increase\033[0m the Rooms" << std::endl;
 	std::cout << "\033[1;33m=========================================\033[0m" << std::endl;
 }
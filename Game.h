@@ -1,10 +1,15 @@
 #pragma once
 
-class Room;
 class Camera;
-class Graph;
+class DungeonGenerator;
+class DungeonMesh;
+class DungeonPrefetcher;
+class DungeonQuadtree;
+class ResourceManager;
+class TextRenderer;
 
-struct Hallway;
+struct DungeonParams;
+struct DungeonResult;
 
 class Game final
 {
@@ -30,36 +35,36 @@ public:
 	void ProcessScrollDownEvent(const SDL_MouseWheelEvent& e);
 
 private:
-	enum CurrentStage
-	{
-		roomSeparation,
-		roomDeletion,
-		delaunyTriangulation,
-		MST,
-		roomConnections,
-		addingHallways,
-		addDeletedRooms,
-		done
-	};
-
 	// DATA MEMBERS
 	const Window m_Window;
 
 	//Settings
 	int m_MinimumNumOfRooms{ 10 };
 	float m_RoomTightness{1.f}; //[1,3]
+	int m_PrefetchDepth{ 2 }; //Dungeons generated ahead on a worker thread, 0 generates them on the main thread
+	double m_GenerationBudgetMs{ 4.0 }; //Time per frame the main thread spends generating when there is no worker, and on editing the dungeon
 
 	//Hidden Settings
-	int m_NumOfRoomsToGen{ m_MinimumNumOfRooms * 2 };
-	CurrentStage m_CurrentStage{ roomSeparation };
 	const int m_CameraMoveSpeed{ 10 };
+	const std::string m_FontPath{ "Fonts/dogica.ttf" };
+	const float m_LevelMargin{ 100.f }; //Space the camera can move past the outermost rooms and hallways
+	const float m_MinZoom{ 0.1f };
 
 	//Class/Struct Instances
-	std::vector<Room*> m_Rooms{};
-	std::vector<Room*> m_DeletedRooms{};
 	Camera* m_pCamera{};
-	Graph* m_pGraph{};
-	std::vector<Hallway> m_Hallways{};
+	DungeonPrefetcher* m_pPrefetcher{};
+	TextRenderer* m_pTextRenderer{}; //Every label goes through this, so fonts are only opened once
+	ResourceManager* m_pResourceManager{}; //Images and icons, loaded once
+	DungeonQuadtree* m_pQuadtree{}; //Over the dungeon on screen, for culling and picking
+	DungeonMesh* m_pDungeonMesh{}; //The dungeon on screen, rebuilt whenever a new one comes in
+	const DungeonResult* m_pDungeon{}; //Owned by the prefetcher or the editor, nullptr while waiting for the next one
+	DungeonGenerator* m_pEditor{}; //Makes the dungeon on screen again the first time it gets edited, and holds it after that
+	bool m_IsEditingDungeon{ false }; //The editor works on the dungeon on screen, which stays up until the editor is done with it
+
+	//Edits the editor did not get yet, they wait until it is done with the last ones
+	bool m_IsNumOfRoomsEdited{ false };
+	int m_DraggedRoomIdx{ -1 };
+	Vector2f m_DragOffset{};
 
 	//Camera Variables
 	Point2f m_CameraPosition{ 0.f, 0.f };
@@ -68,6 +73,12 @@ private:
 	Point2f m_ResetCamera{};
 	float m_ZoomIn{ 1.f };
 
+	//Picking, indices into the rooms of the dungeon on screen, -1 when there is none
+	int m_HoveredRoomIdx{ -1 };
+	int m_SelectedRoomIdx{ -1 };
+	bool m_IsDraggingRoom{ false };
+	Point2f m_DragPosition{}; //Where the mouse was in the world when the selected room was last moved
+
 	//Other Variables
 	bool m_DidDelete{ false };
 	bool m_DoDebug{ false };
@@ -85,8 +96,17 @@ private:
 	void ClearBackground() const;
 
 	void HandleInput();
-	void CreateHallways();
+	void DrawDebug() const;
+	void DrawRoomHighlights() const;
+	DungeonParams CreateDungeonParams() const;
+	void UpdateDungeonParams();
 	void ResetDungeon();
+	void ShowDungeon();
+	//Returns false when there is no dungeon on screen to edit
+	bool BeginEditing();
+	//Hands the waiting edits to the editor once it is done and runs it for the budget, the new dungeon is shown when it is done
+	void UpdateEditing();
+	void SetZoom(float zoom);
 	void HandleDungeonGeneration();
 	void UpdateTimer(float elapsedSec);
 	void PrintControls() const;
@@ -1,17 +1,16 @@
 #pragma once
 #include <cmath>
-#include "pch.h"
+#include <vector>
 
 #include <algorithm>
 
+#include "DelaunayDivideAndConquer.h"
+#include "DelaunayMesh.h"
+#include "DisjointSet.h"
+#include "DynamicSpanningTree.h"
+#include "HilbertCurve.h"
 #include "MathHelpers.h"
-#include  "Texture.h"
-#include <map>
-
-#include <iostream>
-#include <unordered_map>
-
-#define INVALID_MST_GROUP 0
+#include "utils.h"
 
 struct Vertex
 {
@@ -44,7 +43,6 @@ struct Vertex
 	float x;
 	float y;
 	int roomConnectionID{};
-	int MSTGroup{ INVALID_MST_GROUP };
 
 	//Operator Overloading
 	Vertex operator-(const Vertex& vertex) const
@@ -93,19 +91,15 @@ struct Connection
 		start = _start;
 		end = _end;
 
-		weight =sqrtf(powf(end.x - start.x, 2) + powf(end.y - start.y, 2));
+		const float distanceX{ end.x - start.x };
+		const float distanceY{ end.y - start.y };
+		weight = std::sqrt(distanceX * distanceX + distanceY * distanceY);
 	}
 
 	Vertex start;
 	Vertex end;
 	float weight;
 
-	Connection(const Connection& connection)
-	{
-		start = connection.start;
-		end = connection.end;
-		weight = connection.weight;
-	}
 	bool operator==(const Connection& connection) const
 	{
 		return (start == connection.start && end == connection.end);
@@ -116,91 +110,51 @@ struct Connection
 	}
 };
 
-struct Triangle
+//Where the edges of the dynamic spanning tree are in a list, so an edge can be taken out or updated without searching for it.
+//Taking an edge out moves the last one into its place, so the list is not sorted anymore
+class EdgePositions final
 {
 public:
-	Triangle()
-{
-	a = { 0,0 };
-	b = { 0,0 };
-	c = { 0,0 };
-	circumCircle = {};
-
-	ab = { a,b };
-	bc = { b,c };
-	ac = { a,c };
-}
-	Triangle(Vertex _a, Vertex _b, Vertex _c)
+	void Clear()
 	{
-		a = _a;
-		b = _b;
-		c = _c;
-		circumCircle = calculateCircum();
+		m_EdgeIdxs.clear();
+		m_Positions.clear();
+	}
 
-		ab = { a,b };
-		bc = { b,c };
-		ac = { a,c };
+	bool Has(int edgeIdx) const { return edgeIdx < int(m_Positions.size()) && m_Positions[edgeIdx] != -1; }
+	int GetEdgeIdx(int position) const { return m_EdgeIdxs[position]; }
 
-		edges.push_back(ab);
-		edges.push_back(ac);
-		edges.push_back(bc);
+	void Add(std::vector<Connection>& edges, int edgeIdx, const Connection& edge)
+	{
+		if (edgeIdx >= int(m_Positions.size())) m_Positions.resize(edgeIdx + 1, -1);
+		m_Positions[edgeIdx] = int(edges.size());
+		m_EdgeIdxs.emplace_back(edgeIdx);
+		edges.emplace_back(edge);
 	}
 
-	bool operator==(const Triangle& triangle) const
+	void Remove(std::vector<Connection>& edges, int edgeIdx)
 	{
-		return (a == triangle.a && b == triangle.b && c == triangle.c);
+		const int position{ m_Positions[edgeIdx] };
+		m_Positions[edgeIdx] = -1;
+
+		edges[position] = edges.back();
+		m_EdgeIdxs[position] = m_EdgeIdxs.back();
+		if (position != int(edges.size()) - 1) m_Positions[m_EdgeIdxs[position]] = position;
+		edges.pop_back();
+		m_EdgeIdxs.pop_back();
 	}
-	bool operator!=(const Triangle& triangle) const
+
+	//Does nothing when the edge is not in the list
+	void Set(std::vector<Connection>& edges, int edgeIdx, const Connection& edge) const
 	{
-		return (a != triangle.a || b != triangle.b || c != triangle.c);
+		if (Has(edgeIdx)) edges[m_Positions[edgeIdx]] = edge;
 	}
 
-	Vertex a;
-	Vertex b;
-	Vertex c;
-
-	std::vector<Connection> edges;
-
-	Circlef circumCircle{ };
-
 private:
-	//Connections
-	Connection ab;
-	Connection bc;
-	Connection ac;
-
-	Circlef calculateCircum()
-	{
-		//Calculate side lengths
-		const float ab{ sqrtf(powf(b.x - a.x, 2.f) + powf(b.y - a.y, 2.f)) };
-		const float ac{ sqrtf(powf(c.x - a.x, 2.f) + powf(c.y - a.y, 2.f)) };
-		const float cb{ sqrtf(powf(b.x - c.x, 2.f) + powf(b.y - c.y, 2.f)) };
-
-		//Calculate Semi-Perimeter
-		const float semiPerimeter{ (ab + ac + cb) / 2.f };
-
-		//Calculate Area
-		const float area{ sqrtf(semiPerimeter * (semiPerimeter - ab) * (semiPerimeter - ac) * (semiPerimeter - cb)) };
-
-		//Calculate Circle Radius
-		const float radius{ (ab * ac * cb) / (4.f * area) };
-
-		//Calculate Circle Center
-		const Point2f center{ ((b.y - a.y) * (c.y * c.y - a.y * a.y + c.x * c.x - a.x * a.x) - (c.y - a.y) * (b.y * b.y - a.y * a.y + b.x * b.x - a.x * a.x)) /
-			(2 * (c.x - a.x) * (b.y - a.y) - 2 * (b.x - a.x) * (c.y - a.y)),
-			((b.x - a.x) * (c.x * c.x - a.x * a.x + c.y * c.y - a.y * a.y) - (c.x - a.x) * (b.x * b.x - a.x * a.x + b.y * b.y - a.y * a.y)) /
-			(2 * (c.y - a.y) * (b.x - a.x) - 2 * (b.y - a.y) * (c.x - a.x)) };
-
-
-		Circlef circle{};
-		circle.radius = radius;
-		circle.center = center;
-
-		return circle;
-	}
+	std::vector<int> m_EdgeIdxs{}; //By position
+	std::vector<int> m_Positions{}; //By edge, -1 when it is not in the list
 };
 
-
 class Graph
 {
 public:
@@ -209,221 +163,359 @@ public:
 	void SetPoints(const std::vector<Vertex>& pointsIn)
 	{
 		m_PointList = pointsIn;
-		CalculateSuperTriangle();
+		m_IsEditable = false;
+		m_IsTreeDynamic = false;
+
+		int numOfRooms{};
+		for (const auto& point : m_PointList)
+			numOfRooms = std::max(numOfRooms, point.roomConnectionID + 1);
+		m_PointByRoom.assign(numOfRooms, -1);
+		for (int pointIdx{}; pointIdx < int(m_PointList.size()); ++pointIdx)
+			m_PointByRoom[m_PointList[pointIdx].roomConnectionID] = pointIdx;
 	}
 
-	std::vector<Connection> GetRoomConnections() const { return m_RoomConnections; }
+	const std::vector<Vertex>& GetPoints() const { return m_PointList; }
+	const std::vector<Connection>& GetEdges() const { return m_Edges; }
+	const std::vector<Connection>& GetMSTEdges() const { return m_MSTEdges; }
+	const std::vector<Connection>& GetDeletedEdges() const { return m_DeletedEdges; }
+	const std::vector<Connection>& GetRoomConnections() const { return m_RoomConnections; }
+
+	//Rooms of a room connection that an edit added or took out, roomA is the lowest
+	struct ConnectionChange
+	{
+		int roomA;
+		int roomB;
+		bool isAdded;
+	};
+	//Fills in how the edits changed the room connections since the last call in the order it happened, and starts over.
+	//The first edit of a triangulation starts over as well, with every connection added
+	void TakeConnectionChanges(std::vector<ConnectionChange>& changes)
+	{
+		//Swapping keeps the memory of both
+		changes.swap(m_ConnectionChanges);
+		m_ConnectionChanges.clear();
+	}
 
 	void CalculateTriangulation()
 	{
-		m_Triangulation.clear();
+		BeginTriangulation();
+		ContinueTriangulation(int(m_InsertOrder.size()));
+	}
 
-		m_Triangulation.push_back(m_SuperTriangle);
+	//Same edges as CalculateTriangulation, but split up over the threads of the pool. Runs in one go, it cannot be sliced.
+	//The divide and conquer gets the super triangle of the mesh as three extra points, and both settle cocircular points
+	//the same way, so both make the exact same triangulation and the edges to the super triangle are left out of both
+	void CalculateTriangulationParallel(ThreadPool& pool)
+	{
+		m_IsDivideAndConquer = true;
+		m_IsEditable = false;
+		m_IsTreeDynamic = false;
+		m_MeshToPointList.clear();
+		m_SortedXs.clear();
+		m_SortedYs.clear();
+		if (m_PointList.empty())
+		{
+			m_DivideAndConquer.Triangulate(m_SortedXs, m_SortedYs, &pool);
+			return;
+		}
 
+		//Sorted on x and then y, like the divide and conquer needs. Duplicates keep the point with the lowest index like the mesh does
+		const int numOfPoints{ int(m_PointList.size()) };
+		m_InsertOrder.resize(numOfPoints);
+		for (int i{}; i < numOfPoints; ++i)
+			m_InsertOrder[i] = i;
+
+		std::sort(m_InsertOrder.begin(), m_InsertOrder.end(), [this](int pointA, int pointB)
+			{
+				if (m_PointList[pointA].x != m_PointList[pointB].x) return m_PointList[pointA].x < m_PointList[pointB].x;
+				if (m_PointList[pointA].y != m_PointList[pointB].y) return m_PointList[pointA].y < m_PointList[pointB].y;
+				return pointA < pointB;
+			});
+
+		//The super triangle goes in sorted as well, its corners are -1 in m_MeshToPointList. The left one comes before every point,
+		//the right one after every point and the top one somewhere in between
+		const Vertex& firstPoint{ m_PointList[m_InsertOrder.front()] };
+		float minX{ firstPoint.x }, minY{ firstPoint.y };
+		float maxX{ minX }, maxY{ minY };
 		for (const auto& point : m_PointList)
 		{
-			m_BadTriangles.clear();
-			
-			for (const auto& triangle : m_Triangulation)
-			{
-				if (utils::IsPointInCircle(Point2f{ point.x, point.y }, triangle.circumCircle))
-					m_BadTriangles.push_back(triangle);
-			}
-			std::vector<Connection> polygon;
-			for (const auto& badTriangle : m_BadTriangles) 
-			{
-				for (const auto& edge : badTriangle.edges) 
-				{
-					bool isShared = false;
-					for (const auto& badTriangleToCheck : m_BadTriangles) 
-					{
-						if (badTriangle == badTriangleToCheck) continue;
-						for (const auto& edgeToCheckAgainst : badTriangleToCheck.edges) 
-						{
-							if (edge == edgeToCheckAgainst) 
-							{
-								isShared = true;
-								break;
-							}
-						}
-						if (isShared) break;
-					}
-					if (!isShared) polygon.push_back(edge);
-				}
-			}
+			minX = std::min(minX, point.x);
+			minY = std::min(minY, point.y);
+			maxX = std::max(maxX, point.x);
+			maxY = std::max(maxY, point.y);
+		}
+		double superXs[3]{}, superYs[3]{};
+		DelaunayMesh::GetSuperTriangle(minX, minY, maxX, maxY, superXs, superYs);
 
-			//remove bad triangles from triangulation
-			std::vector<Triangle>::iterator it = m_Triangulation.begin();
-			while (it != m_Triangulation.end()) {
-				if (std::find(m_BadTriangles.begin(), m_BadTriangles.end(), *it) != m_BadTriangles.end()) {
-					it = m_Triangulation.erase(it);
-				}
-				else {
-					++it;
-				}
-			}
+		auto AddSorted = [this](int pointIdx, double x, double y)
+		{
+			m_MeshToPointList.emplace_back(pointIdx);
+			m_SortedXs.emplace_back(x);
+			m_SortedYs.emplace_back(y);
+		};
+
+		AddSorted(-1, superXs[0], superYs[0]);
+		bool isTopAdded{ false };
+		int lastPointIdx{ -1 };
+		for (const int pointIdx : m_InsertOrder)
+		{
+			const Vertex& point{ m_PointList[pointIdx] };
+			if (lastPointIdx != -1 && m_PointList[lastPointIdx] == point) continue;
+			lastPointIdx = pointIdx;
 
-			for (const auto& edge : polygon) {
-				Triangle newTriangle{ edge.start, edge.end, point };
-				m_Triangulation.push_back(newTriangle);
+			if (!isTopAdded && (point.x > superXs[2] || (point.x == superXs[2] && point.y > superYs[2])))
+			{
+				AddSorted(-1, superXs[2], superYs[2]);
+				isTopAdded = true;
 			}
+			AddSorted(pointIdx, point.x, point.y);
 		}
+		if (!isTopAdded) AddSorted(-1, superXs[2], superYs[2]);
+		AddSorted(-1, superXs[1], superYs[1]);
 
-		//Not needed for the rooms but if you need the triangulation for anything else this might be needed.
-		//clean the lines up, remove the super triangle
-		//std::vector<Triangle> trianglesToRemove;
-		//for (const auto& triangle : m_Triangulation) {
-		//	 if (triangle.a == m_SuperTriangle.a || triangle.a == m_SuperTriangle.b || triangle.a == m_SuperTriangle.c
-		//	|| triangle.b == m_SuperTriangle.a || triangle.b == m_SuperTriangle.b || triangle.b == m_SuperTriangle.c
-		//	|| triangle.c == m_SuperTriangle.a || triangle.c == m_SuperTriangle.b || triangle.c == m_SuperTriangle.c)
-		//	 {
-		//		trianglesToRemove.push_back(triangle);
-		//	}
-		//}
-		//
-		//for (const auto& triangleToRemove : trianglesToRemove) {
-		//	m_Triangulation.erase(std::remove(m_Triangulation.begin(), m_Triangulation.end(), triangleToRemove), m_Triangulation.end());
-		//}
+		m_DivideAndConquer.Triangulate(m_SortedXs, m_SortedYs, &pool);
 	}
 
-	void CalculateMST()
+	//Sets up the triangulation without inserting any points, ContinueTriangulation inserts them.
+	//Without the Hilbert order the points go in by index, which is only there for the benchmark to compare against
+	void BeginTriangulation(bool isHilbertOrdered = true)
 	{
-		FillEdges();
-
-		std::vector<Connection> mst;
+		m_IsDivideAndConquer = false;
+		m_IsEditable = false;
+		m_IsTreeDynamic = false;
+		m_MeshToPointList.clear();
+		m_PointToMeshList.assign(m_PointList.size(), -1);
+		m_InsertOrder.clear();
+		m_NumOfInsertedPoints = 0;
+		if (m_PointList.empty())
+		{
+			//Still a super triangle, so points can be inserted later on
+			m_Mesh.Begin(0.f, 0.f, 0.f, 0.f);
+			return;
+		}
 
-		std::vector<Vertex> vertices{m_PointList};
-		vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+		float minX{ m_PointList[0].x }, minY{ m_PointList[0].y };
+		float maxX{ minX }, maxY{ minY };
+		for (const auto& point : m_PointList)
+		{
+			minX = std::min(minX, point.x);
+			minY = std::min(minY, point.y);
+			maxX = std::max(maxX, point.x);
+			maxY = std::max(maxY, point.y);
+		}
 
-		int currentMSTGroup{ INVALID_MST_GROUP + 1 };
-		for (auto& edge : m_Edges)
+		//The mesh finds a new point by walking from the last triangle it made, so insert the points along a Hilbert curve
+		//where every point is close to the one before it. The random rounds keep that fast for any room layout.
+		const int numOfPoints{ int(m_PointList.size()) };
+		if (isHilbertOrdered)
 		{
-			if (edge.start.MSTGroup == edge.end.MSTGroup && edge.start.MSTGroup != INVALID_MST_GROUP)
-			{
-				m_DeletedEdges.emplace_back(edge);
-				continue;
-			}
+			const HilbertCurve curve{ minX, minY, maxX, maxY };
+			curve.CreateOrder(numOfPoints, [this](int pointIdx) { return Point2f{ m_PointList[pointIdx].x, m_PointList[pointIdx].y }; },
+				HilbertCurve::GetNumOfRounds(numOfPoints), m_InsertOrder, m_InsertKeys);
+		}
+		else
+		{
+			m_InsertOrder.resize(numOfPoints);
+			for (int i{}; i < numOfPoints; ++i)
+				m_InsertOrder[i] = i;
+		}
 
+		m_Mesh.Begin(minX, minY, maxX, maxY, numOfPoints);
+	}
 
-			if (edge.end.MSTGroup == INVALID_MST_GROUP && edge.start.MSTGroup == INVALID_MST_GROUP)
+	//Inserts up to the given number of points, returns true once all of them are in
+	bool ContinueTriangulation(int maxNumOfPoints)
+	{
+		const int endPoint{ std::min(int(m_InsertOrder.size()), m_NumOfInsertedPoints + maxNumOfPoints) };
+		for (; m_NumOfInsertedPoints < endPoint; ++m_NumOfInsertedPoints)
+		{
+			//Duplicate points get skipped by the mesh, so keep track of which point every mesh point is
+			const int pointIdx{ m_InsertOrder[m_NumOfInsertedPoints] };
+			const int meshIdx{ m_Mesh.InsertPoint(m_PointList[pointIdx].x, m_PointList[pointIdx].y) };
+			if (meshIdx == -1)
 			{
-				edge.end.MSTGroup = currentMSTGroup;
-				edge.start.MSTGroup = currentMSTGroup;
-				++currentMSTGroup;
-
-				for (auto& edgeToCheck : m_Edges)
+				//Of the duplicates the one with the lowest index stays, like the divide and conquer does
+				const int duplicateMeshIdx{ m_Mesh.FindPoint(m_PointList[pointIdx].x, m_PointList[pointIdx].y) };
+				if (duplicateMeshIdx != -1 && pointIdx < m_MeshToPointList[duplicateMeshIdx])
 				{
-					if (edgeToCheck.end == edge.end) edgeToCheck.end.MSTGroup = edge.end.MSTGroup;
-					if (edgeToCheck.start == edge.end) edgeToCheck.start.MSTGroup = edge.end.MSTGroup;
-					if (edgeToCheck.end == edge.start) edgeToCheck.end.MSTGroup = edge.start.MSTGroup;
-					if (edgeToCheck.start == edge.start) edgeToCheck.start.MSTGroup = edge.start.MSTGroup;
+					m_PointToMeshList[m_MeshToPointList[duplicateMeshIdx]] = -1;
+					m_MeshToPointList[duplicateMeshIdx] = pointIdx;
+					m_PointToMeshList[pointIdx] = duplicateMeshIdx;
 				}
+				continue;
 			}
 
-			else if (edge.start.MSTGroup != INVALID_MST_GROUP && edge.end.MSTGroup == INVALID_MST_GROUP)
-			{
-				edge.end.MSTGroup = edge.start.MSTGroup;
-				++currentMSTGroup;
+			m_MeshToPointList.emplace_back(pointIdx);
+			m_PointToMeshList[pointIdx] = meshIdx;
+		}
 
-				for (auto& edgeToCheck : m_Edges)
-				{
-					if (edgeToCheck.end == edge.end) edgeToCheck.end.MSTGroup = edge.end.MSTGroup;
-					if (edgeToCheck.start == edge.end) edgeToCheck.start.MSTGroup = edge.end.MSTGroup;
-					if (edgeToCheck.end == edge.start) edgeToCheck.end.MSTGroup = edge.start.MSTGroup;
-					if (edgeToCheck.start == edge.start) edgeToCheck.start.MSTGroup = edge.start.MSTGroup;
-				}
-			}
+		m_IsEditable = m_NumOfInsertedPoints == int(m_InsertOrder.size());
+		return m_IsEditable;
+	}
 
-			else if (edge.end.MSTGroup != INVALID_MST_GROUP && edge.start.MSTGroup == INVALID_MST_GROUP)
-			{
-				edge.start.MSTGroup = edge.end.MSTGroup;
-				++currentMSTGroup;
+	//Editing a finished triangulation. The mesh only repairs the triangles around the point instead of starting over,
+	//and the minimum spanning tree only swaps the edges that the mesh added and removed. Every edit patches the edge lists
+	//and the room connections right away at the positions of the edges that changed, so CalculateMST and FillRoomConnections
+	//have nothing left to do. The lists are not sorted anymore once the triangulation has been edited.
+	//A triangulation made by CalculateTriangulationParallel gets redone by the mesh the first time it is edited.
+	//The edited mesh has the same edges as a triangulation of the edited points from scratch. Points on top of another point
+	//are left out like CalculateTriangulation does, but which of the two stays can differ, a new triangulation keeps the lowest index
 
-				for (auto& edgeToCheck : m_Edges)
-				{
-					if (edgeToCheck.end == edge.end) edgeToCheck.end.MSTGroup = edge.end.MSTGroup;
-					if (edgeToCheck.start == edge.end) edgeToCheck.start.MSTGroup = edge.end.MSTGroup;
-					if (edgeToCheck.end == edge.start) edgeToCheck.end.MSTGroup = edge.start.MSTGroup;
-					if (edgeToCheck.start == edge.start) edgeToCheck.start.MSTGroup = edge.start.MSTGroup;
-				}
-			}
+	//Returns the index of the new point
+	int InsertPoint(const Vertex& point)
+	{
+		PrepareForEditing();
+
+		const int pointIdx{ int(m_PointList.size()) };
+		m_PointList.emplace_back(point);
+		m_PointToMeshList.emplace_back(-1);
+		if (point.roomConnectionID >= int(m_PointByRoom.size())) m_PointByRoom.resize(point.roomConnectionID + 1, -1);
+		m_PointByRoom[point.roomConnectionID] = pointIdx;
+		AddToMesh(pointIdx);
+		return pointIdx;
+	}
 
-			else if (edge.end.MSTGroup != INVALID_MST_GROUP && edge.start.MSTGroup != INVALID_MST_GROUP && edge.end.MSTGroup != edge.start.MSTGroup)
-			{
-				const int groupToStay{ edge.start.MSTGroup };
-				const int groupToChange{ edge.end.MSTGroup };
-				for (auto& edgeToChange : m_Edges)
-				{
-					if (edgeToChange.start.MSTGroup == groupToChange) edgeToChange.start.MSTGroup = groupToStay;
-					if (edgeToChange.end.MSTGroup == groupToChange) edgeToChange.end.MSTGroup = groupToStay;
-				}
-			}
+	//The last point takes over the index of the removed one
+	void RemovePoint(int pointIdx)
+	{
+		PrepareForEditing();
 
-			mst.emplace_back(edge);
+		const int meshIdx{ m_PointToMeshList[pointIdx] };
+		if (meshIdx != -1)
+		{
+			m_Mesh.RemovePoint(meshIdx);
+			UpdateDynamicTree();
+			m_MeshToPointList[meshIdx] = -1;
 		}
 
-		m_MSTEdges = mst;
+		m_PointByRoom[m_PointList[pointIdx].roomConnectionID] = -1;
+		const int lastPointIdx{ int(m_PointList.size()) - 1 };
+		if (pointIdx != lastPointIdx)
+		{
+			m_PointList[pointIdx] = m_PointList[lastPointIdx];
+			m_PointByRoom[m_PointList[pointIdx].roomConnectionID] = pointIdx;
+			m_PointToMeshList[pointIdx] = m_PointToMeshList[lastPointIdx];
+			if (m_PointToMeshList[pointIdx] != -1)
+				m_MeshToPointList[m_PointToMeshList[pointIdx]] = pointIdx;
+		}
+		m_PointList.pop_back();
+		m_PointToMeshList.pop_back();
 	}
 
-	void DebugDraw() const
+	void MovePoint(int pointIdx, float x, float y)
 	{
-		//Draw Super Triangle
-		Point2f a = Point2f{ m_SuperTriangle.a.x, m_SuperTriangle.a.y };
-		Point2f b = Point2f{ m_SuperTriangle.b.x, m_SuperTriangle.b.y };
-		Point2f c = Point2f{ m_SuperTriangle.c.x, m_SuperTriangle.c.y };
-		utils::SetColor(Color4f{ 1,0,0,1 });
-		utils::DrawPolygon({ a,b,c }, true, 10.f);
+		PrepareForEditing();
 
-		//Draw Circum Circle of Super Triangle
-		Ellipsef circum { m_SuperTriangle.circumCircle.center, m_SuperTriangle.circumCircle.radius, m_SuperTriangle.circumCircle.radius };
-		utils::SetColor(Color4f{ 0,1,0,1 });
-		utils::FillEllipse(m_SuperTriangle.circumCircle.center, 5, 5);
-		utils::DrawEllipse(circum);
+		m_PointList[pointIdx].x = x;
+		m_PointList[pointIdx].y = y;
 
-		for (const auto& triangle : m_Triangulation)
+		const int meshIdx{ m_PointToMeshList[pointIdx] };
+		if (meshIdx == -1)
 		{
-			utils::SetColor(Color4f{ 0,1,0,1 });
-			utils::DrawPolygon( {Point2f{ triangle.a.x, triangle.a.y }, Point2f{ triangle.b.x, triangle.b.y }, Point2f{ triangle.c.x, triangle.c.y }} );
+			AddToMesh(pointIdx);
+			return;
 		}
 
-		for (const auto& point : m_PointList)
+		const bool isMoved{ m_Mesh.MovePoint(meshIdx, x, y) };
+		UpdateDynamicTree();
+		if (isMoved)
 		{
-			utils::DrawEllipse(Point2f{ point.x, point.y }, 5, 5);
+			//The edges it kept got longer or shorter, and all of its edges start or end somewhere else now
+			m_Mesh.ForEachNeighbour(meshIdx, [this, pointIdx](int otherMeshIdx) { RefreshEdge(pointIdx, m_MeshToPointList[otherMeshIdx]); });
 		}
-
-		for (const auto& edge : m_Edges)
+		else
 		{
-			const Texture edgeWeight("W:" + std::to_string(int(std::round(edge.weight))), "Fonts/dogica.ttf", 7, Color4f{ 1,1,1,1 });
-			edgeWeight.Draw(Point2f{ (edge.start.x + edge.end.x) / 2.f, (edge.start.y + edge.end.y) / 2.f });
+			//Moved on top of another point
+			m_MeshToPointList[meshIdx] = -1;
+			m_PointToMeshList[pointIdx] = -1;
 		}
+	}
 
-		for (const auto& edge : m_MSTEdges)
-		{
-			utils::SetColor(Color4f{ 0,0,1,1 });
-			utils::DrawLine(edge.start.x, edge.start.y, edge.end.x, edge.end.y);
-		}
+	//Index of the point of a room, -1 when the room has none
+	int FindPoint(int roomConnectionID) const
+	{
+		if (roomConnectionID < 0 || roomConnectionID >= int(m_PointByRoom.size())) return -1;
+		return m_PointByRoom[roomConnectionID];
+	}
 
-		for (const auto& edge : m_DeletedEdges)
+	void CalculateMST()
+	{
+		BeginMST();
+		ContinueMST(int(m_Edges.size()));
+	}
+
+	//CalculateMST split up. BeginMST gathers and sorts the edges, which cannot be split up,
+	//ContinueMST then runs Kruskal over up to the given number of edges and returns true once the tree is done
+	void BeginMST()
+	{
+		m_NumOfCheckedEdges = 0;
+		if (m_IsTreeDynamic)
 		{
-			utils::SetColor(Color4f{ 1,1,1,1 });
-			utils::DrawLine(edge.start.x, edge.start.y, edge.end.x, edge.end.y);
+			//The edits kept the lists up to date
+			m_NumOfCheckedEdges = int(m_Edges.size());
+			return;
 		}
 
-		for (const auto& edge : m_RoomConnections)
+		FillEdges();
+
+		m_MSTEdges.clear();
+		m_DeletedEdges.clear();
+
+		int numOfRooms{};
+		for (const auto& point : m_PointList)
+			numOfRooms = std::max(numOfRooms, point.roomConnectionID + 1);
+		m_RoomSets.Reset(numOfRooms);
+	}
+
+	bool ContinueMST(int maxNumOfEdges)
+	{
+		//Kruskal: the edges are sorted by weight, so every edge that joins two separate groups of rooms is part of the tree
+		const int endEdge{ std::min(int(m_Edges.size()), m_NumOfCheckedEdges + maxNumOfEdges) };
+		for (; m_NumOfCheckedEdges < endEdge; ++m_NumOfCheckedEdges)
 		{
-			utils::SetColor(Color4f{ 1,0,0,1 });
-			utils::DrawLine(edge.start.x, edge.start.y, edge.end.x, edge.end.y);
+			const Connection& edge{ m_Edges[m_NumOfCheckedEdges] };
+			if (m_RoomSets.Unite(edge.start.roomConnectionID, edge.end.roomConnectionID))
+				m_MSTEdges.emplace_back(edge);
+			else
+				m_DeletedEdges.emplace_back(edge);
 		}
+		return m_NumOfCheckedEdges == int(m_Edges.size());
 	}
 
-	void FillRoomConnections()
+	void FillRoomConnections(Pcg32& random)
 	{
-		m_RoomConnections.clear();
-		m_RoomConnections = m_MSTEdges;
+		//Every edge gets its own stream, picked by its rooms, so whether an edge comes back does not depend on
+		//the edges before it. Editing the dungeon then only changes the loops around the edit.
+		const uint32_t edgeSeed{ random.Next() };
+		const bool isSameSeed{ m_HasConnectionSeed && edgeSeed == m_ConnectionSeed };
+		m_ConnectionSeed = edgeSeed;
+		m_HasConnectionSeed = true;
+
+		if (m_IsTreeDynamic)
+		{
+			//Once the seed is known every edit keeps the connections up to date
+			if (isSameSeed) return;
+
+			for (const auto& edge : m_RoomConnections)
+				m_ConnectionChanges.emplace_back(ConnectionChange{ edge.start.roomConnectionID, edge.end.roomConnectionID, false });
+			m_RoomConnections.clear();
+			m_ConnectionPositions.Clear();
+			for (int position{}; position < int(m_MSTEdges.size()); ++position)
+				AddRoomConnection(m_TreePositions.GetEdgeIdx(position), m_MSTEdges[position]);
+			for (int position{}; position < int(m_DeletedEdges.size()); ++position)
+			{
+				const Connection& edge{ m_DeletedEdges[position] };
+				if (IsLoopEdge(edge.start.roomConnectionID, edge.end.roomConnectionID))
+					AddRoomConnection(m_OtherPositions.GetEdgeIdx(position), edge);
+			}
+			return;
+		}
 
+		//Assigning keeps the memory of the previous dungeon
+		m_RoomConnections = m_MSTEdges;
 		for (const auto& edge : m_DeletedEdges)
 		{
-			if (utils::RandomChange(15))
+			if (IsLoopEdge(edge.start.roomConnectionID, edge.end.roomConnectionID))
 			{
 				m_RoomConnections.emplace_back(edge);
 			}
@@ -432,78 +524,246 @@ public:
 
 	void Reset()
 	{
-		m_SuperTriangle = {};
-		m_Triangulation.clear();
-		m_BadTriangles.clear();
+		m_IsEditable = false;
+		m_IsTreeDynamic = false;
+		m_Mesh.Clear();
+		m_MeshToPointList.clear();
+		m_PointToMeshList.clear();
 		m_PointList.clear();
+		m_PointByRoom.clear();
 		m_Edges.clear();
 		m_MSTEdges.clear();
 		m_DeletedEdges.clear();
 		m_RoomConnections.clear();
+		m_ConnectionChanges.clear();
+		m_HasConnectionSeed = false;
 	}
 
 private:
 	//Member Variables
-	Triangle m_SuperTriangle{};
-	std::vector<Triangle> m_Triangulation{};
-	std::vector<Triangle> m_BadTriangles{};
+	DelaunayMesh m_Mesh{};
+	DelaunayDivideAndConquer m_DivideAndConquer{};
+	bool m_IsDivideAndConquer{ false }; //Which of the two made the last triangulation
+	bool m_IsEditable{ false }; //The mesh holds every point, so it can be edited
+	std::vector<double> m_SortedXs{};
+	std::vector<double> m_SortedYs{};
+	std::vector<int> m_InsertOrder{};
+	std::vector<uint64_t> m_InsertKeys{};
+	int m_NumOfInsertedPoints{};
+	std::vector<int> m_MeshToPointList{}; //-1 for points that were removed from the mesh and for the super triangle of the divide and conquer
+	std::vector<int> m_PointToMeshList{}; //-1 for points that are not in the mesh
 	std::vector<Vertex> m_PointList{};
 	std::vector<Connection> m_Edges{};
 	std::vector<Connection> m_MSTEdges{};
 	std::vector<Connection> m_DeletedEdges{};
 	std::vector<Connection> m_RoomConnections{};
+	DisjointSet m_RoomSets{};
+	int m_NumOfCheckedEdges{}; //How far ContinueMST got
+	DynamicSpanningTree m_DynamicTree{};
+	bool m_IsTreeDynamic{ false }; //m_DynamicTree has followed every edit of the mesh since it was built
+	std::vector<std::pair<int, int>> m_AddedMeshEdges{};
+	std::vector<std::pair<int, int>> m_RemovedMeshEdges{};
+	std::vector<DelaunayMesh::TriangleCorners> m_AddedMeshTriangles{};
+	std::vector<DelaunayMesh::TriangleCorners> m_RemovedMeshTriangles{};
+	std::vector<DynamicSpanningTree::Edge> m_AddedTreeEdges{};
+	std::vector<std::pair<int, int>> m_RemovedTreeEdges{};
+	std::vector<DynamicSpanningTree::Face> m_AddedFaces{};
+	std::vector<DynamicSpanningTree::Face> m_RemovedFaces{};
+	std::vector<DynamicSpanningTree::EdgeChange> m_TreeChanges{};
+	//Where every edge of the tree is in m_Edges, m_MSTEdges, m_DeletedEdges and m_RoomConnections while the tree is dynamic
+	EdgePositions m_EdgePositions{};
+	EdgePositions m_TreePositions{};
+	EdgePositions m_OtherPositions{};
+	EdgePositions m_ConnectionPositions{};
+	std::vector<ConnectionChange> m_ConnectionChanges{}; //Only filled in while the tree is dynamic
+	uint32_t m_ConnectionSeed{};
+	bool m_HasConnectionSeed{ false }; //FillRoomConnections ran, so the edits can keep the connections up to date
+	std::vector<int> m_PointByRoom{}; //Index of the point of every room, -1 for rooms without one. Kept up to date by every edit
 
 	//Function Definitions
-	void CalculateSuperTriangle()
+	void PrepareForEditing()
 	{
-		//Predefine vertices of the SuperTriangle 
-		Vertex a{}, b{}, c{};
+		if (!m_IsEditable)
+			CalculateTriangulation();
+		if (m_IsTreeDynamic) return;
 
-		//Find the point furthest up that is made up from other triangle coordinates
-		Vector2f topRight{ Vector2f{ m_PointList[0].x, m_PointList[0].y} };
-		for (const auto& point : m_PointList)
-		{
-			if (point.x > topRight.x) topRight.x = point.x;
-			if (point.y > topRight.y) topRight.y = point.y;
-		}
-		Vector2f bottomLeft{ Vector2f{ m_PointList[0].x, m_PointList[0].y} };
-		for (const auto& point : m_PointList)
-		{
-			if (point.x < bottomLeft.x) bottomLeft.x = point.x;
-			if (point.y < bottomLeft.y) bottomLeft.y = point.y;
-		}
+		//The first edit builds the tree from every edge and triangle, after that it only follows the ones the mesh adds and removes.
+		//The lists start over, the tree hands every edge to them
+		m_DynamicTree.Clear();
+		m_Edges.clear();
+		m_MSTEdges.clear();
+		m_DeletedEdges.clear();
+		m_RoomConnections.clear();
+		m_EdgePositions.Clear();
+		m_TreePositions.Clear();
+		m_OtherPositions.Clear();
+		m_ConnectionPositions.Clear();
+		m_ConnectionChanges.clear();
+
+		m_AddedTreeEdges.clear();
+		m_RemovedTreeEdges.clear();
+		m_AddedFaces.clear();
+		m_RemovedFaces.clear();
+		m_Mesh.ForEachEdge([this](int meshIdxA, int meshIdxB) { m_AddedTreeEdges.emplace_back(CreateTreeEdge(meshIdxA, meshIdxB)); });
+		m_Mesh.ForEachTriangle([this](int meshIdxA, int meshIdxB, int meshIdxC)
+			{
+				m_AddedFaces.emplace_back(DynamicSpanningTree::Face{ { GetRoomOfMeshPoint(meshIdxA), GetRoomOfMeshPoint(meshIdxB), GetRoomOfMeshPoint(meshIdxC) } });
+			});
+		m_DynamicTree.Update(m_AddedTreeEdges, m_RemovedTreeEdges, m_AddedFaces, m_RemovedFaces);
+		ApplyTreeChanges();
 
-		//Calculate points based on the furthest points we found before
-		const float rectSize{ std::abs(topRight.x - bottomLeft.x) };
-		Vector2f pointA{ topRight.x - rectSize / 2.f, topRight.y * 2};
-		Vector2f pointB{ topRight.x * 2, bottomLeft.y / 2};
-		Vector2f pointC{ bottomLeft.x - 1.5f * rectSize, bottomLeft.y };
+		m_Mesh.SetTrackingEdgeChanges(true);
+		m_IsTreeDynamic = true;
+	}
 
-		const float bottomOffset{ rectSize / 5.f };
-		a = { pointA.x, pointA.y };
-		b = { pointB.x, pointB.y - bottomOffset };
-		c = { pointC.x, pointC.y - bottomOffset };
+	int GetRoomOfMeshPoint(int meshIdx) const { return m_PointList[m_MeshToPointList[meshIdx]].roomConnectionID; }
 
-		m_SuperTriangle = Triangle(a,b,c);
+	DynamicSpanningTree::Edge CreateTreeEdge(int meshIdxA, int meshIdxB) const
+	{
+		const Vertex& pointA{ m_PointList[m_MeshToPointList[meshIdxA]] };
+		const Vertex& pointB{ m_PointList[m_MeshToPointList[meshIdxB]] };
+		return DynamicSpanningTree::Edge{ Connection{ pointA, pointB }.weight, pointA.roomConnectionID, pointB.roomConnectionID };
 	}
 
-	void FillEdges()
+	//Has to run right after the mesh changed, while every point of the removed edges and triangles is still mapped
+	void UpdateDynamicTree()
+	{
+		m_Mesh.TakeEdgeChanges(m_AddedMeshEdges, m_RemovedMeshEdges);
+		m_Mesh.TakeTriangleChanges(m_AddedMeshTriangles, m_RemovedMeshTriangles);
+
+		m_AddedTreeEdges.clear();
+		for (const auto& edge : m_AddedMeshEdges)
+			m_AddedTreeEdges.emplace_back(CreateTreeEdge(edge.first, edge.second));
+		m_RemovedTreeEdges.clear();
+		for (const auto& edge : m_RemovedMeshEdges)
+			m_RemovedTreeEdges.emplace_back(GetRoomOfMeshPoint(edge.first), GetRoomOfMeshPoint(edge.second));
+
+		auto AddFaces = [this](const std::vector<DelaunayMesh::TriangleCorners>& triangles, std::vector<DynamicSpanningTree::Face>& faces)
+		{
+			faces.clear();
+			for (const auto& triangle : triangles)
+			{
+				faces.emplace_back(DynamicSpanningTree::Face{ { GetRoomOfMeshPoint(triangle.points[0]),
+					GetRoomOfMeshPoint(triangle.points[1]), GetRoomOfMeshPoint(triangle.points[2]) } });
+			}
+		};
+		AddFaces(m_AddedMeshTriangles, m_AddedFaces);
+		AddFaces(m_RemovedMeshTriangles, m_RemovedFaces);
+
+		m_DynamicTree.Update(m_AddedTreeEdges, m_RemovedTreeEdges, m_AddedFaces, m_RemovedFaces);
+		ApplyTreeChanges();
+	}
+
+	//The edge between two points that both stayed, one of them moved
+	void RefreshEdge(int pointIdxA, int pointIdxB)
 	{
-		std::vector<Connection> edges{};
+		const Vertex& pointA{ m_PointList[pointIdxA] };
+		const Vertex& pointB{ m_PointList[pointIdxB] };
+		const Connection edge{ pointA.roomConnectionID < pointB.roomConnectionID ? Connection{ pointA, pointB } : Connection{ pointB, pointA } };
+		const int roomA{ edge.start.roomConnectionID }, roomB{ edge.end.roomConnectionID };
+
+		m_DynamicTree.SetWeight(roomA, roomB, edge.weight);
+		ApplyTreeChanges();
+
+		const int edgeIdx{ m_DynamicTree.FindEdge(roomA, roomB) };
+		if (edgeIdx == -1) return;
+		m_EdgePositions.Set(m_Edges, edgeIdx, edge);
+		m_TreePositions.Set(m_MSTEdges, edgeIdx, edge);
+		m_OtherPositions.Set(m_DeletedEdges, edgeIdx, edge);
+		m_ConnectionPositions.Set(m_RoomConnections, edgeIdx, edge);
+	}
 
-		//Add all of the edges that exist into an array
-		for (const auto& triangle : m_Triangulation)
+	//Patches the lists with what the tree changed, every change is a single edge going in or out of a list
+	void ApplyTreeChanges()
+	{
+		m_DynamicTree.TakeChanges(m_TreeChanges);
+		for (const auto& change : m_TreeChanges)
 		{
-			for (const auto& edge : triangle.edges)
+			using EdgeList = DynamicSpanningTree::EdgeList;
+			std::vector<Connection>& edges{ change.list == EdgeList::all ? m_Edges : change.list == EdgeList::tree ? m_MSTEdges : m_DeletedEdges };
+			EdgePositions& positions{ change.list == EdgeList::all ? m_EdgePositions : change.list == EdgeList::tree ? m_TreePositions : m_OtherPositions };
+
+			if (!change.isAdded)
 			{
-				edges.emplace_back(edge);
+				positions.Remove(edges, change.edgeIdx);
+				if (change.list != EdgeList::all && m_ConnectionPositions.Has(change.edgeIdx))
+				{
+					m_ConnectionPositions.Remove(m_RoomConnections, change.edgeIdx);
+					m_ConnectionChanges.emplace_back(ConnectionChange{ change.edge.roomA, change.edge.roomB, false });
+				}
+				continue;
 			}
+
+			const Connection edge{ CreateEdge(change.edge) };
+			positions.Add(edges, change.edgeIdx, edge);
+
+			//The room connections are the tree and the other edges FillRoomConnections picked
+			if (m_HasConnectionSeed && (change.list == EdgeList::tree || (change.list == EdgeList::other && IsLoopEdge(change.edge.roomA, change.edge.roomB))))
+				AddRoomConnection(change.edgeIdx, edge);
 		}
+	}
 
-		//Remove all the duplicates while also sorting the array
-		std::sort(edges.begin(), edges.end());
-		edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+	void AddRoomConnection(int edgeIdx, const Connection& edge)
+	{
+		m_ConnectionPositions.Add(m_RoomConnections, edgeIdx, edge);
+		m_ConnectionChanges.emplace_back(ConnectionChange{ edge.start.roomConnectionID, edge.end.roomConnectionID, true });
+	}
+
+	Connection CreateEdge(const DynamicSpanningTree::Edge& edge) const
+	{
+		return Connection{ m_PointList[m_PointByRoom[edge.roomA]], m_PointList[m_PointByRoom[edge.roomB]] };
+	}
+
+	//Whether an edge that is not in the tree becomes a room connection, roomA is the lowest
+	bool IsLoopEdge(int roomA, int roomB) const
+	{
+		Pcg32 edgeRandom{ m_ConnectionSeed, (uint64_t(uint32_t(roomA)) << 32) | uint32_t(roomB) };
+		return utils::RandomChange(edgeRandom, 15);
+	}
+
+	void AddToMesh(int pointIdx)
+	{
+		//The mesh gives removed indices out again
+		const int meshIdx{ m_Mesh.InsertPoint(m_PointList[pointIdx].x, m_PointList[pointIdx].y) };
+		if (meshIdx != -1)
+		{
+			if (meshIdx == int(m_MeshToPointList.size())) m_MeshToPointList.emplace_back(pointIdx);
+			else m_MeshToPointList[meshIdx] = pointIdx;
+			m_PointToMeshList[pointIdx] = meshIdx;
+		}
 
-		m_Edges = edges;
+		//Even a duplicate can have made the mesh grow its super triangle
+		UpdateDynamicTree();
+	}
+
+	void FillEdges()
+	{
+		m_Edges.clear();
+
+		//Both give every edge once, the edges to the super triangle are left out.
+		//Which way round an edge comes out depends on how the triangles got made, so every edge starts at the lowest room id
+		//and the same weights are sorted on the ids. Then the same triangulation always gives the same dungeon, whether
+		//it came from the mesh, the divide and conquer or a mesh that got edited.
+		auto AddEdge = [this](int pointA, int pointB)
+		{
+			//The super triangle of the divide and conquer
+			if (m_MeshToPointList[pointA] == -1 || m_MeshToPointList[pointB] == -1) return;
+
+			const Vertex& start{ m_PointList[m_MeshToPointList[pointA]] };
+			const Vertex& end{ m_PointList[m_MeshToPointList[pointB]] };
+			if (start.roomConnectionID <= end.roomConnectionID) m_Edges.emplace_back(start, end);
+			else m_Edges.emplace_back(end, start);
+		};
+		if (m_IsDivideAndConquer) m_DivideAndConquer.ForEachEdge(AddEdge);
+		else m_Mesh.ForEachEdge(AddEdge);
+
+		std::sort(m_Edges.begin(), m_Edges.end(), IsLighterEdge);
+	}
+
+	static bool IsLighterEdge(const Connection& edgeA, const Connection& edgeB)
+	{
+		if (edgeA.weight != edgeB.weight) return edgeA.weight < edgeB.weight;
+		if (edgeA.start.roomConnectionID != edgeB.start.roomConnectionID) return edgeA.start.roomConnectionID < edgeB.start.roomConnectionID;
+		return edgeA.end.roomConnectionID < edgeB.end.roomConnectionID;
 	}
 };
\ No newline at end of file
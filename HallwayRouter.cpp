@@ -0,0 +1,356 @@
+#include "HallwayRouter.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+	struct OpenNode
+	{
+		float cost; //Cost so far plus the estimate to the goal
+		int cell;
+	};
+
+	//Smallest cost on top, ties go to the lowest cell so the paths do not depend on the heap
+	bool IsWorseNode(const OpenNode& a, const OpenNode& b)
+	{
+		if (a.cost != b.cost) return a.cost > b.cost;
+		return a.cell > b.cell;
+	}
+
+	constexpr uint8_t noDirection{ 4 };
+
+	//Search state that is kept around between searches, one per thread so generators on different threads do not share it.
+	//The stamps say which search wrote a cell, so nothing has to be cleared before a new search.
+	struct SearchScratch
+	{
+		std::vector<float> costs{};
+		std::vector<int> parents{};
+		std::vector<uint8_t> directions{};
+		std::vector<uint32_t> openStamps{};
+		std::vector<uint32_t> closedStamps{};
+		uint32_t currentStamp{};
+
+		std::vector<OpenNode> openList{};
+		std::vector<int> path{};
+
+		void Prepare(int numOfCells)
+		{
+			if (int(openStamps.size()) < numOfCells || currentStamp == UINT32_MAX)
+			{
+				costs.resize(numOfCells);
+				parents.resize(numOfCells);
+				directions.resize(numOfCells);
+				openStamps.assign(numOfCells, 0);
+				closedStamps.assign(numOfCells, 0);
+				currentStamp = 0;
+			}
+
+			++currentStamp;
+			openList.clear();
+			path.clear();
+		}
+	};
+
+	thread_local SearchScratch g_SearchScratch{};
+}
+
+void HallwayRouter::Begin(const RoomStore& rooms)
+{
+	BeginGrid(rooms);
+	while (!ContinueGrid(rooms, INT_MAX)) {}
+}
+
+void HallwayRouter::BeginGrid(const RoomStore& rooms)
+{
+	m_Width = m_Height = 0;
+	m_NextCell = m_NextRoom = 0;
+
+	bool hasRooms{ false };
+	float left{}, bottom{}, right{}, top{};
+	for (int roomIdx{}; roomIdx < rooms.GetSize(); ++roomIdx)
+	{
+		if (!rooms.IsAlive(roomIdx)) continue;
+
+		const Rectf rect{ rooms.GetRect(roomIdx) };
+		if (!hasRooms)
+		{
+			left = right = rect.left;
+			bottom = top = rect.bottom;
+			hasRooms = true;
+		}
+		left = std::min(left, rect.left);
+		bottom = std::min(bottom, rect.bottom);
+		right = std::max(right, rect.left + rect.width);
+		top = std::max(top, rect.bottom + rect.height);
+	}
+	if (!hasRooms)
+	{
+		m_CellRooms.clear();
+		m_CellHallways.clear();
+		return;
+	}
+
+	m_Left = left - m_Border * m_CellSize;
+	m_Bottom = bottom - m_Border * m_CellSize;
+	m_Width = int(std::ceil((right - left) / m_CellSize)) + 2 * m_Border;
+	m_Height = int(std::ceil((top - bottom) / m_CellSize)) + 2 * m_Border;
+
+	//Only cells the grid did not have before get filled in here, ContinueGrid clears the rest
+	m_CellRooms.resize(size_t(m_Width) * size_t(m_Height));
+	m_CellHallways.resize(size_t(m_Width) * size_t(m_Height));
+}
+
+bool HallwayRouter::ContinueGrid(const RoomStore& rooms, int maxCells)
+{
+	const int numOfCells{ int(m_CellRooms.size()) };
+	int cellsLeft{ maxCells };
+
+	if (m_NextCell < numOfCells)
+	{
+		const int endCell{ numOfCells - m_NextCell > cellsLeft ? m_NextCell + cellsLeft : numOfCells };
+		std::fill(m_CellRooms.begin() + m_NextCell, m_CellRooms.begin() + endCell, -1);
+		std::fill(m_CellHallways.begin() + m_NextCell, m_CellHallways.begin() + endCell, CellHallways{});
+		cellsLeft -= endCell - m_NextCell;
+		m_NextCell = endCell;
+		if (m_NextCell < numOfCells) return false;
+	}
+	if (numOfCells == 0) return true;
+
+	//A cell belongs to a room when its center is inside of the room
+	for (; m_NextRoom < rooms.GetSize() && cellsLeft > 0; ++m_NextRoom)
+	{
+		const int roomIdx{ m_NextRoom };
+		--cellsLeft;
+		if (!rooms.IsAlive(roomIdx)) continue;
+
+		int firstX{}, lastX{}, firstY{}, lastY{};
+		GetCells(rooms.GetRect(roomIdx), firstX, lastX, firstY, lastY);
+		for (int y{ firstY }; y <= lastY; ++y)
+		{
+			for (int x{ firstX }; x <= lastX; ++x)
+				m_CellRooms[y * m_Width + x] = roomIdx;
+		}
+		cellsLeft -= std::max(0, lastX - firstX + 1) * std::max(0, lastY - firstY + 1);
+	}
+	return m_NextRoom == rooms.GetSize();
+}
+
+bool HallwayRouter::Route(const RoomStore& rooms, int fromIdx, int toIdx, std::vector<Hallway>& hallways, bool isWholePath)
+{
+	if (m_CellRooms.empty()) return false;
+
+	const int startCell{ GetCell(rooms.GetCenter(fromIdx)) };
+	const int goalCell{ GetCell(rooms.GetCenter(toIdx)) };
+	if (startCell == goalCell) return true;
+
+	const int goalX{ goalCell % m_Width }, goalY{ goalCell / m_Width };
+	const int cellOffsets[4]{ 1, m_Width, -1, -m_Width };
+
+	SearchScratch& scratch{ g_SearchScratch };
+	scratch.Prepare(m_Width * m_Height);
+	const uint32_t stamp{ scratch.currentStamp };
+
+	scratch.costs[startCell] = 0.f;
+	scratch.parents[startCell] = -1;
+	scratch.directions[startCell] = noDirection;
+	scratch.openStamps[startCell] = stamp;
+	scratch.openList.emplace_back(OpenNode{ 0.f, startCell });
+
+	//The estimate assumes every cell is a new hallway. That overestimates when there are hallways to follow,
+	//which keeps the search close to the straight line at the cost of sometimes missing a cheaper detour over a hallway.
+	auto EstimateCost = [&](int cell)
+	{
+		return float(std::abs(cell % m_Width - goalX) + std::abs(cell / m_Width - goalY)) * m_NewHallwayCost;
+	};
+
+	bool isGoalFound{ false };
+	while (!scratch.openList.empty())
+	{
+		std::pop_heap(scratch.openList.begin(), scratch.openList.end(), IsWorseNode);
+		const int cell{ scratch.openList.back().cell };
+		scratch.openList.pop_back();
+
+		//Cells get added again when a cheaper way to them is found, the old entries are skipped
+		if (scratch.closedStamps[cell] == stamp) continue;
+		scratch.closedStamps[cell] = stamp;
+
+		if (cell == goalCell)
+		{
+			isGoalFound = true;
+			break;
+		}
+
+		const int cellX{ cell % m_Width }, cellY{ cell / m_Width };
+		for (int direction{}; direction < 4; ++direction)
+		{
+			if ((direction == 0 && cellX == m_Width - 1) || (direction == 1 && cellY == m_Height - 1)
+				|| (direction == 2 && cellX == 0) || (direction == 3 && cellY == 0))
+				continue;
+
+			const int neighbour{ cell + cellOffsets[direction] };
+			if (scratch.closedStamps[neighbour] == stamp) continue;
+
+			//Hallways can only go through the rooms they connect
+			const int room{ m_CellRooms[neighbour] };
+			if (room != -1 && room != fromIdx && room != toIdx) continue;
+
+			float cost{ scratch.costs[cell] + (IsHallway(cell, direction) ? m_ExistingHallwayCost : m_NewHallwayCost) };
+			if (scratch.directions[cell] != noDirection && scratch.directions[cell] != direction) cost += m_TurnCost;
+
+			if (scratch.openStamps[neighbour] == stamp && cost >= scratch.costs[neighbour]) continue;
+
+			scratch.openStamps[neighbour] = stamp;
+			scratch.costs[neighbour] = cost;
+			scratch.parents[neighbour] = cell;
+			scratch.directions[neighbour] = uint8_t(direction);
+
+			scratch.openList.emplace_back(OpenNode{ cost + EstimateCost(neighbour), neighbour });
+			std::push_heap(scratch.openList.begin(), scratch.openList.end(), IsWorseNode);
+		}
+	}
+
+	if (!isGoalFound) return false;
+
+	for (int cell{ goalCell }; cell != -1; cell = scratch.parents[cell])
+		scratch.path.emplace_back(cell);
+	std::reverse(scratch.path.begin(), scratch.path.end());
+
+	//Turn the path into straight hallways, skipping the parts that are already a hallway
+	int runStart{ -1 };
+	int runDirection{ noDirection };
+	for (int i{}; i + 1 < int(scratch.path.size()); ++i)
+	{
+		const int cell{ scratch.path[i] };
+		const int direction{ scratch.directions[scratch.path[i + 1]] };
+		const bool isNewHallway{ isWholePath || !IsHallway(cell, direction) };
+
+		if (runStart != -1 && isNewHallway && direction == runDirection) continue;
+
+		if (runStart != -1)
+			hallways.emplace_back(GetCellCenter(runStart), GetCellCenter(cell));
+
+		runStart = isNewHallway ? cell : -1;
+		runDirection = direction;
+	}
+	if (runStart != -1)
+		hallways.emplace_back(GetCellCenter(runStart), GetCellCenter(scratch.path.back()));
+
+	for (int i{}; i + 1 < int(scratch.path.size()); ++i)
+		AddHallway(scratch.path[i], scratch.directions[scratch.path[i + 1]]);
+
+	return true;
+}
+
+void HallwayRouter::RemovePath(const std::vector<Hallway>& wholePath, int firstHallway, int numOfHallways)
+{
+	const int cellOffsets[4]{ 1, m_Width, -1, -m_Width };
+	for (int hallwayIdx{ firstHallway }; hallwayIdx < firstHallway + numOfHallways; ++hallwayIdx)
+	{
+		//Every hallway goes straight from the center of one cell to another
+		const Hallway& hallway{ wholePath[hallwayIdx] };
+		const int endCell{ GetCell(hallway.endPoint) };
+		int cell{ GetCell(hallway.startingPoint) };
+		if (cell == endCell) continue;
+
+		int direction{};
+		if (hallway.endPoint.x < hallway.startingPoint.x) direction = 2;
+		else if (hallway.endPoint.y > hallway.startingPoint.y) direction = 1;
+		else if (hallway.endPoint.y < hallway.startingPoint.y) direction = 3;
+
+		for (; cell != endCell; cell += cellOffsets[direction])
+		{
+			uint16_t& count{ GetHallwayCount(cell, direction) };
+			if (count != UINT16_MAX) --count;
+		}
+	}
+}
+
+void HallwayRouter::RemoveRoom(const Rectf& rect, int roomIdx)
+{
+	if (m_CellRooms.empty()) return;
+
+	int firstX{}, lastX{}, firstY{}, lastY{};
+	GetCells(rect, firstX, lastX, firstY, lastY);
+	for (int y{ firstY }; y <= lastY; ++y)
+	{
+		for (int x{ firstX }; x <= lastX; ++x)
+		{
+			if (m_CellRooms[y * m_Width + x] == roomIdx) m_CellRooms[y * m_Width + x] = -1;
+		}
+	}
+}
+
+void HallwayRouter::AddRoom(const RoomStore& rooms, int roomIdx)
+{
+	if (m_CellRooms.empty()) return;
+
+	int firstX{}, lastX{}, firstY{}, lastY{};
+	GetCells(rooms.GetRect(roomIdx), firstX, lastX, firstY, lastY);
+	for (int y{ firstY }; y <= lastY; ++y)
+	{
+		for (int x{ firstX }; x <= lastX; ++x)
+			m_CellRooms[y * m_Width + x] = roomIdx;
+	}
+}
+
+bool HallwayRouter::IsOnGrid(const Rectf& rect) const
+{
+	if (m_CellRooms.empty()) return false;
+
+	const float border{ m_Border * m_CellSize };
+	return rect.left >= m_Left + border && rect.bottom >= m_Bottom + border
+		&& rect.left + rect.width <= m_Left + m_Width * m_CellSize - border
+		&& rect.bottom + rect.height <= m_Bottom + m_Height * m_CellSize - border;
+}
+
+int HallwayRouter::GetCell(const Point2f& point) const
+{
+	const int x{ std::clamp(int((point.x - m_Left) / m_CellSize), 0, m_Width - 1) };
+	const int y{ std::clamp(int((point.y - m_Bottom) / m_CellSize), 0, m_Height - 1) };
+	return y * m_Width + x;
+}
+
+Point2f HallwayRouter::GetCellCenter(int cell) const
+{
+	return Point2f{ m_Left + (float(cell % m_Width) + 0.5f) * m_CellSize, m_Bottom + (float(cell / m_Width) + 0.5f) * m_CellSize };
+}
+
+void HallwayRouter::GetCells(const Rectf& rect, int& firstX, int& lastX, int& firstY, int& lastY) const
+{
+	firstX = std::max(0, int(std::ceil((rect.left - m_Left) / m_CellSize - 0.5f)));
+	lastX = std::min(m_Width - 1, int(std::floor((rect.left + rect.width - m_Left) / m_CellSize - 0.5f)));
+	firstY = std::max(0, int(std::ceil((rect.bottom - m_Bottom) / m_CellSize - 0.5f)));
+	lastY = std::min(m_Height - 1, int(std::floor((rect.bottom + rect.height - m_Bottom) / m_CellSize - 0.5f)));
+}
+
+bool HallwayRouter::IsHallway(int cell, int direction) const
+{
+	switch (direction)
+	{
+	case 0: return m_CellHallways[cell].right != 0;
+	case 1: return m_CellHallways[cell].up != 0;
+	case 2: return m_CellHallways[cell - 1].right != 0;
+	case 3: return m_CellHallways[cell - m_Width].up != 0;
+	}
+	return false;
+}
+
+uint16_t& HallwayRouter::GetHallwayCount(int cell, int direction)
+{
+	switch (direction)
+	{
+	case 0: return m_CellHallways[cell].right;
+	case 1: return m_CellHallways[cell].up;
+	case 2: return m_CellHallways[cell - 1].right;
+	default: return m_CellHallways[cell - m_Width].up;
+	}
+}
+
+void HallwayRouter::AddHallway(int cell, int direction)
+{
+	uint16_t& count{ GetHallwayCount(cell, direction) };
+	if (count != UINT16_MAX) ++count;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Room.h"
+
+//Routes hallways over a hidden grid with A*.
+//Rooms are obstacles for every hallway that does not start or end in them, and walking along a hallway that is already
+//there is cheaper than making a new one, so hallways merge into corridors instead of running next to each other.
+class HallwayRouter final
+{
+public:
+	HallwayRouter() = default;
+
+	//Puts the alive rooms on the grid and forgets all of the hallways of the previous dungeon
+	void Begin(const RoomStore& rooms);
+	//Begin split up for big dungeons. BeginGrid only sizes the grid, every ContinueGrid call after it clears about maxCells cells
+	//or puts rooms covering about that many cells on the grid, it returns true once the grid is ready
+	void BeginGrid(const RoomStore& rooms);
+	bool ContinueGrid(const RoomStore& rooms, int maxCells);
+	//Adds the straight parts of the path between the centers of both rooms that are not a hallway yet, or all of them with isWholePath.
+	//Returns false when the rooms could not be reached, nothing gets added then.
+	bool Route(const RoomStore& rooms, int fromIdx, int toIdx, std::vector<Hallway>& hallways, bool isWholePath = false);
+
+	//Editing the grid of a finished dungeon, so only the hallways that change have to be routed again.
+	//Every part of a path is counted, a part stops being a hallway once every path that went over it is taken out
+	void RemovePath(const std::vector<Hallway>& wholePath, int firstHallway, int numOfHallways);
+	//Takes the cells of the room within the rect off the grid, the rect is where the room was when it was put on
+	void RemoveRoom(const Rectf& rect, int roomIdx);
+	void AddRoom(const RoomStore& rooms, int roomIdx);
+	//Whether the rect fits on the grid with the free border around it, otherwise the grid has to be made again
+	bool IsOnGrid(const Rectf& rect) const;
+
+private:
+	static constexpr float m_CellSize{ 10.f };
+	static constexpr int m_Border{ 4 }; //Free cells around the rooms so hallways can go around the outside
+
+	//Costs of moving one cell
+	static constexpr float m_NewHallwayCost{ 1.f };
+	static constexpr float m_ExistingHallwayCost{ 0.4f };
+	static constexpr float m_TurnCost{ 2.f };
+
+	//Number of paths that go to the cell on the right and to the cell above. A count that reaches the maximum stays there
+	struct CellHallways
+	{
+		uint16_t right;
+		uint16_t up;
+	};
+
+	float m_Left{}, m_Bottom{};
+	int m_Width{}, m_Height{};
+	std::vector<int> m_CellRooms{}; //Store index of the room on the cell, -1 for none
+	std::vector<CellHallways> m_CellHallways{};
+	int m_NextCell{}, m_NextRoom{}; //How far ContinueGrid got
+
+	int GetCell(const Point2f& point) const;
+	Point2f GetCellCenter(int cell) const;
+	//Cells with their center inside of the rect, the last ones are lower than the first ones when there are none
+	void GetCells(const Rectf& rect, int& firstX, int& lastX, int& firstY, int& lastY) const;
+	bool IsHallway(int cell, int direction) const;
+	uint16_t& GetHallwayCount(int cell, int direction);
+	void AddHallway(int cell, int direction);
+};
@@ -0,0 +1,107 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "Random.h"
+#include "structs.h"
+
+//Hilbert curve stretched over a rectangle. Points that are close together on the curve are close together in space,
+//so going over points in curve order keeps the memory they touch and the walks through a triangulation short.
+class HilbertCurve final
+{
+public:
+	//The cells stay square, so the curve covers the longest side of the bounds
+	HilbertCurve(float minX, float minY, float maxX, float maxY)
+		: m_MinX{ minX }
+		, m_MinY{ minY }
+		, m_Scale{ float(m_GridSize - 1) / std::max({ maxX - minX, maxY - minY, 0.001f }) }
+	{
+	}
+
+	uint32_t GetIndex(const Point2f& point) const
+	{
+		const float maxCell{ float(m_GridSize - 1) };
+		const uint32_t cellX{ uint32_t(std::clamp((point.x - m_MinX) * m_Scale, 0.f, maxCell)) };
+		const uint32_t cellY{ uint32_t(std::clamp((point.y - m_MinY) * m_Scale, 0.f, maxCell)) };
+		return GetCellIndex(cellX, cellY);
+	}
+
+	//Position of a cell on the curve through the 65536 x 65536 grid
+	static uint32_t GetCellIndex(uint32_t cellX, uint32_t cellY)
+	{
+		//Going down a level turns the quadrant so the curve inside of it starts and ends next to the quadrants around it.
+		//The turns are swapping x and y and mirroring both, which do not depend on each other, so two flags keep track of them
+		//and the bits of every level get turned the same way without any branches.
+		uint32_t index{}, isSwapped{}, isMirrored{};
+		for (int bit{ m_NumOfBits - 1 }; bit >= 0; --bit)
+		{
+			uint32_t isRight{ ((cellX >> bit) & 1u) ^ isMirrored };
+			uint32_t isTop{ ((cellY >> bit) & 1u) ^ isMirrored };
+			const uint32_t swap{ (isRight ^ isTop) & isSwapped };
+			isRight ^= swap;
+			isTop ^= swap;
+
+			index = (index << 2) | ((3 * isRight) ^ isTop);
+
+			const uint32_t isTurned{ isTop ^ 1u };
+			isSwapped ^= isTurned;
+			isMirrored ^= isTurned & isRight;
+		}
+		return index;
+	}
+
+	//Enough rounds that the first one still holds around m_MinPointsPerRound points
+	static int GetNumOfRounds(int numOfPoints)
+	{
+		int numOfRounds{ 1 };
+		while ((numOfPoints >> numOfRounds) >= m_MinPointsPerRound)
+			++numOfRounds;
+		return numOfRounds;
+	}
+
+	//Fills order with the indices of the points in curve order, getPosition(i) gives the Point2f of point i.
+	//With more than one round this is a biased randomized insertion order: every point goes into one of the rounds,
+	//each round holding about twice as many points as the one before it, and every round follows the curve on its own.
+	//The random rounds keep a triangulation fast whatever order the points come in, the curve keeps it local.
+	//The rounds are random but always the same for the same points. keys is scratch.
+	template<typename PositionFunction>
+	void CreateOrder(int numOfPoints, PositionFunction getPosition, int numOfRounds, std::vector<int>& order, std::vector<uint64_t>& keys) const
+	{
+		//Round, curve index and point index all fit in one key, so sorting the keys sorts the points.
+		//The point index breaks the ties, which keeps the order the same on every platform.
+		Pcg32 random{ uint64_t(numOfPoints), 0 };
+		keys.resize(numOfPoints);
+		for (int pointIdx{}; pointIdx < numOfPoints; ++pointIdx)
+		{
+			//The last round gets half of the points, the one before it a quarter and so on
+			int round{ numOfRounds - 1 };
+			uint32_t coins{ random.Next() };
+			while (round > 0 && (coins & 1u) == 0)
+			{
+				--round;
+				coins >>= 1;
+			}
+
+			keys[pointIdx] = (uint64_t(round) << m_RoundShift) | (uint64_t(GetIndex(getPosition(pointIdx))) << m_IndexBits) | uint64_t(pointIdx);
+		}
+
+		std::sort(keys.begin(), keys.end());
+
+		order.resize(numOfPoints);
+		for (int i{}; i < numOfPoints; ++i)
+			order[i] = int(keys[i] & ((uint64_t(1) << m_IndexBits) - 1));
+	}
+
+private:
+	static constexpr int m_NumOfBits{ 16 };
+	static constexpr uint32_t m_GridSize{ 1u << m_NumOfBits };
+	static constexpr int m_MinPointsPerRound{ 64 };
+	//Keys are [round: 5 bits][curve index: 32 bits][point index: 27 bits]
+	static constexpr int m_IndexBits{ 27 };
+	static constexpr int m_RoundShift{ 32 + m_IndexBits };
+
+	float m_MinX;
+	float m_MinY;
+	float m_Scale;
+};
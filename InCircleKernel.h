@@ -0,0 +1,128 @@
+#pragma once
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define INCIRCLE_USE_SSE2
+#endif
+#include <cmath>
+
+#include "Predicates.h"
+
+//Tests one point against a batch of circles at once with the plain part of utils::InCircle.
+//Every circle goes through the corners of a counter clockwise triangle, stored as separate arrays so a batch loads straight into registers.
+//Uses AVX when the compiler is allowed to, SSE2 on every other x86 target and plain code everywhere else. Every path computes
+//the same expression and error bound as InCircle, so a lane it is sure about has the sign InCircle would give,
+//the lanes it is not sure about are left for the exact predicates.
+namespace utils
+{
+	constexpr int g_CirclesPerBatch{ 8 };
+
+	struct CircleBatch
+	{
+		double ax[g_CirclesPerBatch];
+		double ay[g_CirclesPerBatch];
+		double bx[g_CirclesPerBatch];
+		double by[g_CirclesPerBatch];
+		double cx[g_CirclesPerBatch];
+		double cy[g_CirclesPerBatch];
+	};
+
+	//Bit i is set when the point is certainly inside circle i, bit i of uncertainMask when the rounding error
+	//could have flipped the sign and InCircle has to decide. Only the first numOfCircles circles are used
+	inline unsigned int PointInCircles(double x, double y, const CircleBatch& batch, int numOfCircles, unsigned int& uncertainMask)
+	{
+		unsigned int insideMask{};
+		uncertainMask = 0;
+
+#if defined(__AVX__)
+		const __m256d pointX{ _mm256_set1_pd(x) };
+		const __m256d pointY{ _mm256_set1_pd(y) };
+		const __m256d signBit{ _mm256_set1_pd(-0.0) };
+		const __m256d errorBound{ _mm256_set1_pd(g_InCircleErrorBound) };
+
+		for (int i{}; i < numOfCircles; i += 4)
+		{
+			const __m256d adx{ _mm256_sub_pd(_mm256_loadu_pd(batch.ax + i), pointX) }, ady{ _mm256_sub_pd(_mm256_loadu_pd(batch.ay + i), pointY) };
+			const __m256d bdx{ _mm256_sub_pd(_mm256_loadu_pd(batch.bx + i), pointX) }, bdy{ _mm256_sub_pd(_mm256_loadu_pd(batch.by + i), pointY) };
+			const __m256d cdx{ _mm256_sub_pd(_mm256_loadu_pd(batch.cx + i), pointX) }, cdy{ _mm256_sub_pd(_mm256_loadu_pd(batch.cy + i), pointY) };
+
+			const __m256d bdxcdy{ _mm256_mul_pd(bdx, cdy) }, cdxbdy{ _mm256_mul_pd(cdx, bdy) };
+			const __m256d cdxady{ _mm256_mul_pd(cdx, ady) }, adxcdy{ _mm256_mul_pd(adx, cdy) };
+			const __m256d adxbdy{ _mm256_mul_pd(adx, bdy) }, bdxady{ _mm256_mul_pd(bdx, ady) };
+			const __m256d aLift{ _mm256_add_pd(_mm256_mul_pd(adx, adx), _mm256_mul_pd(ady, ady)) };
+			const __m256d bLift{ _mm256_add_pd(_mm256_mul_pd(bdx, bdx), _mm256_mul_pd(bdy, bdy)) };
+			const __m256d cLift{ _mm256_add_pd(_mm256_mul_pd(cdx, cdx), _mm256_mul_pd(cdy, cdy)) };
+
+			const __m256d det{ _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(aLift, _mm256_sub_pd(bdxcdy, cdxbdy)),
+				_mm256_mul_pd(bLift, _mm256_sub_pd(cdxady, adxcdy))), _mm256_mul_pd(cLift, _mm256_sub_pd(adxbdy, bdxady))) };
+			const __m256d permanent{ _mm256_add_pd(_mm256_add_pd(
+				_mm256_mul_pd(_mm256_add_pd(_mm256_andnot_pd(signBit, bdxcdy), _mm256_andnot_pd(signBit, cdxbdy)), aLift),
+				_mm256_mul_pd(_mm256_add_pd(_mm256_andnot_pd(signBit, cdxady), _mm256_andnot_pd(signBit, adxcdy)), bLift)),
+				_mm256_mul_pd(_mm256_add_pd(_mm256_andnot_pd(signBit, adxbdy), _mm256_andnot_pd(signBit, bdxady)), cLift)) };
+			const __m256d bound{ _mm256_mul_pd(errorBound, permanent) };
+
+			insideMask |= static_cast<unsigned int>(_mm256_movemask_pd(_mm256_cmp_pd(det, bound, _CMP_GT_OQ))) << i;
+			uncertainMask |= static_cast<unsigned int>(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_andnot_pd(signBit, det), bound, _CMP_LE_OQ))) << i;
+		}
+#elif defined(INCIRCLE_USE_SSE2)
+		const __m128d pointX{ _mm_set1_pd(x) };
+		const __m128d pointY{ _mm_set1_pd(y) };
+		const __m128d signBit{ _mm_set1_pd(-0.0) };
+		const __m128d errorBound{ _mm_set1_pd(g_InCircleErrorBound) };
+
+		for (int i{}; i < numOfCircles; i += 2)
+		{
+			const __m128d adx{ _mm_sub_pd(_mm_loadu_pd(batch.ax + i), pointX) }, ady{ _mm_sub_pd(_mm_loadu_pd(batch.ay + i), pointY) };
+			const __m128d bdx{ _mm_sub_pd(_mm_loadu_pd(batch.bx + i), pointX) }, bdy{ _mm_sub_pd(_mm_loadu_pd(batch.by + i), pointY) };
+			const __m128d cdx{ _mm_sub_pd(_mm_loadu_pd(batch.cx + i), pointX) }, cdy{ _mm_sub_pd(_mm_loadu_pd(batch.cy + i), pointY) };
+
+			const __m128d bdxcdy{ _mm_mul_pd(bdx, cdy) }, cdxbdy{ _mm_mul_pd(cdx, bdy) };
+			const __m128d cdxady{ _mm_mul_pd(cdx, ady) }, adxcdy{ _mm_mul_pd(adx, cdy) };
+			const __m128d adxbdy{ _mm_mul_pd(adx, bdy) }, bdxady{ _mm_mul_pd(bdx, ady) };
+			const __m128d aLift{ _mm_add_pd(_mm_mul_pd(adx, adx), _mm_mul_pd(ady, ady)) };
+			const __m128d bLift{ _mm_add_pd(_mm_mul_pd(bdx, bdx), _mm_mul_pd(bdy, bdy)) };
+			const __m128d cLift{ _mm_add_pd(_mm_mul_pd(cdx, cdx), _mm_mul_pd(cdy, cdy)) };
+
+			const __m128d det{ _mm_add_pd(_mm_add_pd(_mm_mul_pd(aLift, _mm_sub_pd(bdxcdy, cdxbdy)),
+				_mm_mul_pd(bLift, _mm_sub_pd(cdxady, adxcdy))), _mm_mul_pd(cLift, _mm_sub_pd(adxbdy, bdxady))) };
+			const __m128d permanent{ _mm_add_pd(_mm_add_pd(
+				_mm_mul_pd(_mm_add_pd(_mm_andnot_pd(signBit, bdxcdy), _mm_andnot_pd(signBit, cdxbdy)), aLift),
+				_mm_mul_pd(_mm_add_pd(_mm_andnot_pd(signBit, cdxady), _mm_andnot_pd(signBit, adxcdy)), bLift)),
+				_mm_mul_pd(_mm_add_pd(_mm_andnot_pd(signBit, adxbdy), _mm_andnot_pd(signBit, bdxady)), cLift)) };
+			const __m128d bound{ _mm_mul_pd(errorBound, permanent) };
+
+			insideMask |= static_cast<unsigned int>(_mm_movemask_pd(_mm_cmpgt_pd(det, bound))) << i;
+			uncertainMask |= static_cast<unsigned int>(_mm_movemask_pd(_mm_cmple_pd(_mm_andnot_pd(signBit, det), bound))) << i;
+		}
+#else
+		for (int i{}; i < numOfCircles; ++i)
+		{
+			const double adx{ batch.ax[i] - x }, ady{ batch.ay[i] - y };
+			const double bdx{ batch.bx[i] - x }, bdy{ batch.by[i] - y };
+			const double cdx{ batch.cx[i] - x }, cdy{ batch.cy[i] - y };
+
+			const double bdxcdy{ bdx * cdy }, cdxbdy{ cdx * bdy };
+			const double cdxady{ cdx * ady }, adxcdy{ adx * cdy };
+			const double adxbdy{ adx * bdy }, bdxady{ bdx * ady };
+			const double aLift{ adx * adx + ady * ady };
+			const double bLift{ bdx * bdx + bdy * bdy };
+			const double cLift{ cdx * cdx + cdy * cdy };
+
+			const double det{ aLift * (bdxcdy - cdxbdy) + bLift * (cdxady - adxcdy) + cLift * (adxbdy - bdxady) };
+			const double permanent{ (std::abs(bdxcdy) + std::abs(cdxbdy)) * aLift
+				+ (std::abs(cdxady) + std::abs(adxcdy)) * bLift
+				+ (std::abs(adxbdy) + std::abs(bdxady)) * cLift };
+			const double bound{ g_InCircleErrorBound * permanent };
+
+			if (det > bound) insideMask |= 1u << i;
+			if (std::abs(det) <= bound) uncertainMask |= 1u << i;
+		}
+#endif
+
+		//The vector paths also went over the lanes after numOfCircles
+		const unsigned int usedMask{ (1u << numOfCircles) - 1 };
+		uncertainMask &= usedMask;
+		return insideMask & usedMask;
+	}
+}
@@ -1,17 +1,18 @@
 #pragma once
-#include <iostream>
+#include <cmath>
+
+#include "Random.h"
 
 namespace utils
 {
 	inline bool AreEqual(float a, float b, float epsilon = 0.00001f)
 	{
-		return abs(a - b) < epsilon;
+		return std::abs(a - b) < epsilon;
 	}
 
-	
-	inline bool RandomChange(int percentage)
+	inline bool RandomChange(Pcg32& random, int percentage)
 	{
-		const int randomValue{ rand() % 101 };
+		const int randomValue{ random.NextInt(101) };
 		if (randomValue < percentage) return true;
 		else return false;
 	}
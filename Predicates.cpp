@@ -0,0 +1,335 @@
+#include "Predicates.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	//A number is kept as an expansion: doubles that do not overlap, sorted from the smallest to the biggest magnitude,
+	//whose sum is the exact value. The biggest one has the sign of the whole expansion.
+	constexpr double g_Epsilon{ utils::g_PredicateEpsilon };
+	constexpr double g_Splitter{ 134217729.0 }; //2^27 + 1
+	constexpr double g_ResultErrorBound{ (3.0 + 8.0 * g_Epsilon) * g_Epsilon };
+	constexpr double g_OrientErrorBoundB{ (2.0 + 12.0 * g_Epsilon) * g_Epsilon };
+	constexpr double g_OrientErrorBoundC{ (9.0 + 64.0 * g_Epsilon) * g_Epsilon * g_Epsilon };
+
+	//The exact in circle test multiplies expansions of at most this many components
+	constexpr int g_MaxFactorLength{ 16 };
+	constexpr int g_MaxProductLength{ 2 * g_MaxFactorLength * g_MaxFactorLength };
+
+	//sum + error == a + b exactly, needs |a| >= |b|
+	void FastTwoSum(double a, double b, double& sum, double& error)
+	{
+		sum = a + b;
+		error = b - (sum - a);
+	}
+
+	void TwoSum(double a, double b, double& sum, double& error)
+	{
+		sum = a + b;
+		const double bVirtual{ sum - a };
+		const double aVirtual{ sum - bVirtual };
+		error = (a - aVirtual) + (b - bVirtual);
+	}
+
+	void TwoDiff(double a, double b, double& difference, double& error)
+	{
+		difference = a - b;
+		const double bVirtual{ a - difference };
+		const double aVirtual{ difference + bVirtual };
+		error = (a - aVirtual) + (bVirtual - b);
+	}
+
+	//Splits a in two halves of 26 bits so their products are exact
+	void Split(double a, double& high, double& low)
+	{
+		const double scaled{ g_Splitter * a };
+		const double big{ scaled - a };
+		high = scaled - big;
+		low = a - high;
+	}
+
+	void TwoProduct(double a, double b, double& product, double& error)
+	{
+		product = a * b;
+		double aHigh{}, aLow{}, bHigh{}, bLow{};
+		Split(a, aHigh, aLow);
+		Split(b, bHigh, bLow);
+		const double error1{ product - aHigh * bHigh };
+		const double error2{ error1 - aLow * bHigh };
+		const double error3{ error2 - aHigh * bLow };
+		error = aLow * bLow - error3;
+	}
+
+	//(a1 + a0) - (b1 + b0) as a four component expansion
+	void TwoTwoDiff(double a1, double a0, double b1, double b0, double* pResult)
+	{
+		double i{}, j{}, zero{};
+		TwoDiff(a0, b0, i, pResult[0]);
+		TwoSum(a1, i, j, zero);
+		TwoDiff(zero, b1, i, pResult[1]);
+		TwoSum(j, i, pResult[3], pResult[2]);
+	}
+
+	double Estimate(const double* pExpansion, int length)
+	{
+		double sum{ pExpansion[0] };
+		for (int i{ 1 }; i < length; ++i)
+			sum += pExpansion[i];
+		return sum;
+	}
+
+	//h = e + f without zero components, h can not be e or f
+	int SumExpansions(const double* pE, int eLength, const double* pF, int fLength, double* pH)
+	{
+		int eIdx{}, fIdx{}, hLength{};
+		double eNow{ pE[0] }, fNow{ pF[0] };
+		double sum{}, error{};
+
+		//Always takes the smallest component next
+		auto TakeSmallest = [&]()
+		{
+			double value{};
+			if ((fNow > eNow) == (fNow > -eNow))
+			{
+				value = eNow;
+				if (++eIdx < eLength) eNow = pE[eIdx];
+			}
+			else
+			{
+				value = fNow;
+				if (++fIdx < fLength) fNow = pF[fIdx];
+			}
+			return value;
+		};
+
+		double q{ TakeSmallest() };
+		if (eIdx < eLength && fIdx < fLength)
+		{
+			FastTwoSum(TakeSmallest(), q, sum, error);
+			q = sum;
+			if (error != 0.0) pH[hLength++] = error;
+
+			while (eIdx < eLength && fIdx < fLength)
+			{
+				TwoSum(q, TakeSmallest(), sum, error);
+				q = sum;
+				if (error != 0.0) pH[hLength++] = error;
+			}
+		}
+		for (; eIdx < eLength; ++eIdx)
+		{
+			TwoSum(q, pE[eIdx], sum, error);
+			q = sum;
+			if (error != 0.0) pH[hLength++] = error;
+		}
+		for (; fIdx < fLength; ++fIdx)
+		{
+			TwoSum(q, pF[fIdx], sum, error);
+			q = sum;
+			if (error != 0.0) pH[hLength++] = error;
+		}
+
+		if (q != 0.0 || hLength == 0) pH[hLength++] = q;
+		return hLength;
+	}
+
+	//h = e * b without zero components, h can not be e
+	int ScaleExpansion(const double* pE, int eLength, double b, double* pH)
+	{
+		int hLength{};
+		double q{}, error{};
+		TwoProduct(pE[0], b, q, error);
+		if (error != 0.0) pH[hLength++] = error;
+
+		for (int i{ 1 }; i < eLength; ++i)
+		{
+			double product{}, productError{}, sum{};
+			TwoProduct(pE[i], b, product, productError);
+			TwoSum(q, productError, sum, error);
+			if (error != 0.0) pH[hLength++] = error;
+			FastTwoSum(product, sum, q, error);
+			if (error != 0.0) pH[hLength++] = error;
+		}
+
+		if (q != 0.0 || hLength == 0) pH[hLength++] = q;
+		return hLength;
+	}
+
+	//h = e * f, both factors can have at most g_MaxFactorLength components
+	int MultiplyExpansions(const double* pE, int eLength, const double* pF, int fLength, double* pH)
+	{
+		double product[2 * g_MaxFactorLength];
+		double sum[g_MaxProductLength];
+
+		int hLength{ ScaleExpansion(pE, eLength, pF[0], pH) };
+		for (int i{ 1 }; i < fLength; ++i)
+		{
+			const int productLength{ ScaleExpansion(pE, eLength, pF[i], product) };
+			hLength = SumExpansions(pH, hLength, product, productLength, sum);
+			for (int j{}; j < hLength; ++j)
+				pH[j] = sum[j];
+		}
+		return hLength;
+	}
+
+	//a - b as an expansion of one or two components
+	int ExactDifference(double a, double b, double* pH)
+	{
+		double difference{}, error{};
+		TwoDiff(a, b, difference, error);
+		if (error == 0.0)
+		{
+			pH[0] = difference;
+			return 1;
+		}
+		pH[0] = error;
+		pH[1] = difference;
+		return 2;
+	}
+
+	void Negate(double* pExpansion, int length)
+	{
+		for (int i{}; i < length; ++i)
+			pExpansion[i] = -pExpansion[i];
+	}
+}
+
+double utils::Orient2dAdaptive(double ax, double ay, double bx, double by, double cx, double cy, double detSum)
+{
+	const double acx{ ax - cx }, bcx{ bx - cx };
+	const double acy{ ay - cy }, bcy{ by - cy };
+
+	double detLeft{}, detLeftError{}, detRight{}, detRightError{};
+	TwoProduct(acx, bcy, detLeft, detLeftError);
+	TwoProduct(acy, bcx, detRight, detRightError);
+
+	double b[4];
+	TwoTwoDiff(detLeft, detLeftError, detRight, detRightError, b);
+
+	double det{ Estimate(b, 4) };
+	double errorBound{ g_OrientErrorBoundB * detSum };
+	if (det >= errorBound || -det >= errorBound) return det;
+
+	//The rounding errors of the differences themselves
+	double acxTail{}, bcxTail{}, acyTail{}, bcyTail{}, unused{};
+	TwoDiff(ax, cx, unused, acxTail);
+	TwoDiff(bx, cx, unused, bcxTail);
+	TwoDiff(ay, cy, unused, acyTail);
+	TwoDiff(by, cy, unused, bcyTail);
+	if (acxTail == 0.0 && acyTail == 0.0 && bcxTail == 0.0 && bcyTail == 0.0) return det;
+
+	errorBound = g_OrientErrorBoundC * detSum + g_ResultErrorBound * std::abs(det);
+	det += (acx * bcyTail + bcy * acxTail) - (acy * bcxTail + bcx * acyTail);
+	if (det >= errorBound || -det >= errorBound) return det;
+
+	//Add the missing terms exactly
+	double s1{}, s0{}, t1{}, t0{};
+	double u[4], c1[8], c2[12], d[16];
+
+	TwoProduct(acxTail, bcy, s1, s0);
+	TwoProduct(acyTail, bcx, t1, t0);
+	TwoTwoDiff(s1, s0, t1, t0, u);
+	const int c1Length{ SumExpansions(b, 4, u, 4, c1) };
+
+	TwoProduct(acx, bcyTail, s1, s0);
+	TwoProduct(acy, bcxTail, t1, t0);
+	TwoTwoDiff(s1, s0, t1, t0, u);
+	const int c2Length{ SumExpansions(c1, c1Length, u, 4, c2) };
+
+	TwoProduct(acxTail, bcyTail, s1, s0);
+	TwoProduct(acyTail, bcxTail, t1, t0);
+	TwoTwoDiff(s1, s0, t1, t0, u);
+	const int dLength{ SumExpansions(c2, c2Length, u, 4, d) };
+
+	return d[dLength - 1];
+}
+
+double utils::InCircleExact(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy)
+{
+	double adx[2], ady[2], bdx[2], bdy[2], cdx[2], cdy[2];
+	const int adxLength{ ExactDifference(ax, dx, adx) }, adyLength{ ExactDifference(ay, dy, ady) };
+	const int bdxLength{ ExactDifference(bx, dx, bdx) }, bdyLength{ ExactDifference(by, dy, bdy) };
+	const int cdxLength{ ExactDifference(cx, dx, cdx) }, cdyLength{ ExactDifference(cy, dy, cdy) };
+
+	double first[8], second[8];
+
+	//x * x + y * y
+	auto Lift = [&](const double* pX, int xLength, const double* pY, int yLength, double* pLift)
+	{
+		const int firstLength{ MultiplyExpansions(pX, xLength, pX, xLength, first) };
+		const int secondLength{ MultiplyExpansions(pY, yLength, pY, yLength, second) };
+		return SumExpansions(first, firstLength, second, secondLength, pLift);
+	};
+	//x1 * y2 - x2 * y1
+	auto Cross = [&](const double* pX1, int x1Length, const double* pY2, int y2Length,
+		const double* pX2, int x2Length, const double* pY1, int y1Length, double* pCross)
+	{
+		const int firstLength{ MultiplyExpansions(pX1, x1Length, pY2, y2Length, first) };
+		const int secondLength{ MultiplyExpansions(pX2, x2Length, pY1, y1Length, second) };
+		Negate(second, secondLength);
+		return SumExpansions(first, firstLength, second, secondLength, pCross);
+	};
+
+	double aLift[g_MaxFactorLength], bLift[g_MaxFactorLength], cLift[g_MaxFactorLength];
+	const int aLiftLength{ Lift(adx, adxLength, ady, adyLength, aLift) };
+	const int bLiftLength{ Lift(bdx, bdxLength, bdy, bdyLength, bLift) };
+	const int cLiftLength{ Lift(cdx, cdxLength, cdy, cdyLength, cLift) };
+
+	double bc[g_MaxFactorLength], ca[g_MaxFactorLength], ab[g_MaxFactorLength];
+	const int bcLength{ Cross(bdx, bdxLength, cdy, cdyLength, cdx, cdxLength, bdy, bdyLength, bc) };
+	const int caLength{ Cross(cdx, cdxLength, ady, adyLength, adx, adxLength, cdy, cdyLength, ca) };
+	const int abLength{ Cross(adx, adxLength, bdy, bdyLength, bdx, bdxLength, ady, adyLength, ab) };
+
+	double aTerm[g_MaxProductLength], bTerm[g_MaxProductLength], cTerm[g_MaxProductLength];
+	const int aTermLength{ MultiplyExpansions(aLift, aLiftLength, bc, bcLength, aTerm) };
+	const int bTermLength{ MultiplyExpansions(bLift, bLiftLength, ca, caLength, bTerm) };
+	const int cTermLength{ MultiplyExpansions(cLift, cLiftLength, ab, abLength, cTerm) };
+
+	double abTerm[2 * g_MaxProductLength], det[3 * g_MaxProductLength];
+	const int abTermLength{ SumExpansions(aTerm, aTermLength, bTerm, bTermLength, abTerm) };
+	const int detLength{ SumExpansions(abTerm, abTermLength, cTerm, cTermLength, det) };
+
+	return det[detLength - 1];
+}
+
+double utils::InCircleTieBreak(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy)
+{
+	//The determinant works on the points lifted onto x^2 + y^2. Lifting one point a little higher changes it by the orientation
+	//of the other three, with these signs. The first point gets lifted the most, so the first one whose orientation is not zero decides
+	const double xs[4]{ ax, bx, cx, dx };
+	const double ys[4]{ ay, by, cy, dy };
+
+	//A point on top of another one is on the circle, that is not a tie
+	for (int pointA{}; pointA < 4; ++pointA)
+	{
+		for (int pointB{ pointA + 1 }; pointB < 4; ++pointB)
+		{
+			if (xs[pointA] == xs[pointB] && ys[pointA] == ys[pointB]) return 0.0;
+		}
+	}
+	auto LiftDerivative = [&](int point)
+	{
+		switch (point)
+		{
+		case 0: return Orient2d(bx, by, cx, cy, dx, dy);
+		case 1: return -Orient2d(ax, ay, cx, cy, dx, dy);
+		case 2: return Orient2d(ax, ay, bx, by, dx, dy);
+		}
+		return -Orient2d(ax, ay, bx, by, cx, cy);
+	};
+
+	int order[4]{ 0, 1, 2, 3 };
+	std::sort(order, order + 4, [&](int pointA, int pointB)
+		{
+			if (xs[pointA] != xs[pointB]) return xs[pointA] < xs[pointB];
+			return ys[pointA] < ys[pointB];
+		});
+
+	for (const int point : order)
+	{
+		const double derivative{ LiftDerivative(point) };
+		if (derivative != 0.0) return derivative;
+	}
+	return 0.0;
+}
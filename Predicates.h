@@ -0,0 +1,75 @@
+#pragma once
+#include <cmath>
+
+//Geometric predicates that always get the sign right, after Shewchuk's "Adaptive Precision Floating-Point Arithmetic
+//and Fast Robust Geometric Predicates". They first use plain doubles and only redo the calculation exactly when the
+//rounding error could have flipped the sign, which only happens for (nearly) collinear or cocircular points.
+//The plain part is inline since the triangulations call it for every step, the exact part lives in Predicates.cpp.
+//The exact part relies on plain IEEE double arithmetic, so do not build this with fast math or fused multiply adds.
+namespace utils
+{
+	constexpr double g_PredicateEpsilon{ 1.1102230246251565e-16 }; //2^-53
+	constexpr double g_OrientErrorBound{ (3.0 + 16.0 * g_PredicateEpsilon) * g_PredicateEpsilon };
+	constexpr double g_InCircleErrorBound{ (10.0 + 96.0 * g_PredicateEpsilon) * g_PredicateEpsilon };
+
+	//Only for Orient2d and InCircle, for when the plain calculation could not be trusted
+	double Orient2dAdaptive(double ax, double ay, double bx, double by, double cx, double cy, double detSum);
+	double InCircleExact(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy);
+
+	//Positive when a, b and c are counter clockwise, negative when they are clockwise and zero when they are collinear
+	inline double Orient2d(double ax, double ay, double bx, double by, double cx, double cy)
+	{
+		const double detLeft{ (ax - cx) * (by - cy) };
+		const double detRight{ (ay - cy) * (bx - cx) };
+		const double det{ detLeft - detRight };
+
+		//When both sides have a different sign there is no cancellation and det always passes the test below,
+		//checking for that with branches costs more than it saves on points that are spread out randomly
+		const double detSum{ std::abs(detLeft) + std::abs(detRight) };
+		const double errorBound{ g_OrientErrorBound * detSum };
+		if (std::abs(det) >= errorBound) return det;
+
+		return Orient2dAdaptive(ax, ay, bx, by, cx, cy, detSum);
+	}
+
+	//Positive when d is inside of the circle through the counter clockwise a, b and c, negative when it is outside
+	//and zero when the four points are cocircular
+	inline double InCircle(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy)
+	{
+		const double adx{ ax - dx }, ady{ ay - dy };
+		const double bdx{ bx - dx }, bdy{ by - dy };
+		const double cdx{ cx - dx }, cdy{ cy - dy };
+
+		const double bdxcdy{ bdx * cdy }, cdxbdy{ cdx * bdy };
+		const double cdxady{ cdx * ady }, adxcdy{ adx * cdy };
+		const double adxbdy{ adx * bdy }, bdxady{ bdx * ady };
+		const double aLift{ adx * adx + ady * ady };
+		const double bLift{ bdx * bdx + bdy * bdy };
+		const double cLift{ cdx * cdx + cdy * cdy };
+
+		const double det{ aLift * (bdxcdy - cdxbdy) + bLift * (cdxady - adxcdy) + cLift * (adxbdy - bdxady) };
+		const double permanent{ (std::abs(bdxcdy) + std::abs(cdxbdy)) * aLift
+			+ (std::abs(cdxady) + std::abs(adxcdy)) * bLift
+			+ (std::abs(adxbdy) + std::abs(bdxady)) * cLift };
+
+		const double errorBound{ g_InCircleErrorBound * permanent };
+		if (std::abs(det) > errorBound) return det;
+
+		return InCircleExact(ax, ay, bx, by, cx, cy, dx, dy);
+	}
+
+	//Only for InCircleWithTies, for when the four points are cocircular
+	double InCircleTieBreak(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy);
+
+	//InCircle that never says cocircular unless all four points are on one line. Cocircular points get sorted on x and then y,
+	//and the first one counts as if its distance to the center was a tiny bit bigger (simulation of simplicity).
+	//That picks the same diagonal for every four cocircular points no matter which three make the triangle,
+	//so every triangulation that uses it ends up with the same edges for the same points
+	inline double InCircleWithTies(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy)
+	{
+		const double det{ InCircle(ax, ay, bx, by, cx, cy, dx, dy) };
+		if (det != 0.0) return det;
+
+		return InCircleTieBreak(ax, ay, bx, by, cx, cy, dx, dy);
+	}
+}
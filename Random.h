@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+
+//PCG32 random number generator (pcg-random.org).
+//Small, fast and every seed has 2^63 independent streams, so every stage of a dungeon can get its own stream
+//and adding a random call to one stage does not change what the other stages get.
+class Pcg32 final
+{
+public:
+	Pcg32()
+		:Pcg32(0, 0)
+	{
+	}
+	Pcg32(uint64_t seed, uint64_t stream)
+	{
+		Seed(seed, stream);
+	}
+
+	void Seed(uint64_t seed, uint64_t stream)
+	{
+		m_State = 0;
+		m_Increment = (stream << 1u) | 1u;
+		Next();
+		m_State += seed;
+		Next();
+	}
+
+	uint32_t Next()
+	{
+		const uint64_t oldState{ m_State };
+		m_State = oldState * 6364136223846793005ull + m_Increment;
+
+		const uint32_t xorShifted{ uint32_t(((oldState >> 18u) ^ oldState) >> 27u) };
+		const uint32_t rotation{ uint32_t(oldState >> 59u) };
+		return (xorShifted >> rotation) | (xorShifted << ((~rotation + 1u) & 31u));
+	}
+
+	//Number in [0, bound) without the bias of a plain modulo
+	uint32_t NextBounded(uint32_t bound)
+	{
+		if (bound <= 1) return 0;
+
+		const uint32_t threshold{ (~bound + 1u) % bound };
+		while (true)
+		{
+			const uint32_t value{ Next() };
+			if (value >= threshold) return value % bound;
+		}
+	}
+
+	//Number in [0, bound), 0 when the bound is not positive
+	int NextInt(int bound)
+	{
+		return bound > 0 ? int(NextBounded(uint32_t(bound))) : 0;
+	}
+
+private:
+	uint64_t m_State{};
+	uint64_t m_Increment{};
+};
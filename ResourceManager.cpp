@@ -0,0 +1,165 @@
+#include "pch.h"
+#include "ResourceManager.h"
+
+#include <algorithm>
+#include <iostream>
+
+ResourceManager::~ResourceManager()
+{
+	//Let the decodes that are still running finish, so every surface can be freed
+	m_Loader.Wait();
+	for (const auto& image : m_DecodedImages)
+		SDL_FreeSurface(image.pSurface);
+
+	if (m_AtlasTextureId != 0)
+		glDeleteTextures(1, &m_AtlasTextureId);
+}
+
+int ResourceManager::RequestIcon(const std::string& path)
+{
+	const auto it{ m_IconIds.find(path) };
+	if (it != m_IconIds.end()) return it->second;
+
+	const int iconId{ int(m_Icons.size()) };
+	m_Icons.emplace_back();
+	m_IconIds[path] = iconId;
+
+	m_Loader.Enqueue([this, path, iconId]
+		{
+			SDL_Surface* pSurface{ IMG_Load(path.c_str()) };
+			if (pSurface == nullptr)
+			{
+				std::cerr << "ResourceManager::RequestIcon, error when calling IMG_Load: " << IMG_GetError() << std::endl;
+			}
+			else
+			{
+				//Every image ends up in the same format as the atlas, so it can be uploaded as is
+				SDL_Surface* pConvertedSurface{ SDL_ConvertSurfaceFormat(pSurface, SDL_PIXELFORMAT_RGBA32, 0) };
+				SDL_FreeSurface(pSurface);
+				pSurface = pConvertedSurface;
+			}
+
+			std::lock_guard<std::mutex> lock{ m_DecodedMutex };
+			m_DecodedImages.emplace_back(DecodedImage{ iconId, pSurface });
+		});
+
+	return iconId;
+}
+
+void ResourceManager::Update()
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_DecodedMutex };
+		if (m_DecodedImages.empty()) return;
+		m_ImagesToPack.swap(m_DecodedImages);
+	}
+
+	if (m_AtlasTextureId == 0)
+		CreateAtlas();
+
+	for (const auto& image : m_ImagesToPack)
+	{
+		PackImage(image);
+		SDL_FreeSurface(image.pSurface);
+	}
+	m_ImagesToPack.clear();
+}
+
+bool ResourceManager::IsIconReady(int iconId) const
+{
+	return iconId >= 0 && iconId < int(m_Icons.size()) && m_Icons[iconId].isReady;
+}
+
+Point2f ResourceManager::GetIconSize(int iconId) const
+{
+	if (!IsIconReady(iconId)) return Point2f{};
+	return Point2f{ m_Icons[iconId].width, m_Icons[iconId].height };
+}
+
+void ResourceManager::QueueIcon(int iconId, const Rectf& dstRect)
+{
+	if (!IsIconReady(iconId)) return;
+
+	const Icon& icon{ m_Icons[iconId] };
+	const float left{ dstRect.left }, right{ dstRect.left + dstRect.width };
+	const float bottom{ dstRect.bottom }, top{ dstRect.bottom + dstRect.height };
+
+	//Same winding and texture orientation as Texture::Draw
+	m_Vertices.insert(m_Vertices.end(), { left, bottom, left, top, right, top, right, bottom });
+	m_TexCoords.insert(m_TexCoords.end(), { icon.texLeft, icon.texBottom, icon.texLeft, icon.texTop,
+		icon.texRight, icon.texTop, icon.texRight, icon.texBottom });
+}
+
+void ResourceManager::Flush()
+{
+	if (m_Vertices.empty()) return;
+
+	//Icons go on top of the shapes that were batched before them
+	utils::FlushDrawBatch();
+
+	glBindTexture(GL_TEXTURE_2D, m_AtlasTextureId);
+	glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+	glEnable(GL_TEXTURE_2D);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+
+	glVertexPointer(2, GL_FLOAT, 0, m_Vertices.data());
+	glTexCoordPointer(2, GL_FLOAT, 0, m_TexCoords.data());
+	glDrawArrays(GL_QUADS, 0, GLsizei(m_Vertices.size() / 2));
+
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glDisable(GL_TEXTURE_2D);
+
+	//Keeps the memory for the next frame
+	m_Vertices.clear();
+	m_TexCoords.clear();
+}
+
+void ResourceManager::CreateAtlas()
+{
+	//Start out transparent, so sampling next to an icon never picks up garbage
+	const std::vector<unsigned char> emptyPixels(size_t(m_AtlasSize) * size_t(m_AtlasSize) * 4, 0);
+
+	glGenTextures(1, &m_AtlasTextureId);
+	glBindTexture(GL_TEXTURE_2D, m_AtlasTextureId);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_AtlasSize, m_AtlasSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, emptyPixels.data());
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+}
+
+void ResourceManager::PackImage(const DecodedImage& image)
+{
+	if (image.pSurface == nullptr) return;
+
+	const int width{ image.pSurface->w }, height{ image.pSurface->h };
+	//A pixel between the icons so they do not bleed into each other
+	if (m_NextX + width > m_AtlasSize)
+	{
+		m_NextX = 0;
+		m_NextY += m_RowHeight + 1;
+		m_RowHeight = 0;
+	}
+	if (width > m_AtlasSize || m_NextY + height > m_AtlasSize)
+	{
+		std::cerr << "ResourceManager::PackImage, the icon atlas is full, an icon of " << width << 'x' << height << " does not fit\n";
+		return;
+	}
+
+	glBindTexture(GL_TEXTURE_2D, m_AtlasTextureId);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, image.pSurface->pitch / 4);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, m_NextX, m_NextY, width, height, GL_RGBA, GL_UNSIGNED_BYTE, image.pSurface->pixels);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+	Icon& icon{ m_Icons[image.iconId] };
+	icon.width = float(width);
+	icon.height = float(height);
+	icon.texLeft = float(m_NextX) / m_AtlasSize;
+	icon.texRight = float(m_NextX + width) / m_AtlasSize;
+	icon.texTop = float(m_NextY) / m_AtlasSize;
+	icon.texBottom = float(m_NextY + height) / m_AtlasSize;
+	icon.isReady = true;
+
+	m_NextX += width + 1;
+	m_RowHeight = std::max(m_RowHeight, height);
+}
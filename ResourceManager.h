@@ -0,0 +1,73 @@
+#pragma once
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ThreadPool.h"
+
+//Loads every image once and packs it into one shared icon atlas.
+//Decoding the files happens on a worker thread, the results are uploaded into the atlas on the OpenGL thread in Update,
+//so asking for an icon never stalls a frame. Icons are drawn as queued quads with one draw call per flush.
+class ResourceManager final
+{
+public:
+	ResourceManager() = default;
+	ResourceManager(const ResourceManager& other) = delete;
+	ResourceManager& operator=(const ResourceManager& other) = delete;
+	ResourceManager(ResourceManager&& other) = delete;
+	ResourceManager& operator=(ResourceManager&& other) = delete;
+	~ResourceManager();
+
+	//Starts loading the image the first time it is asked for, the same path always gives the same id
+	int RequestIcon(const std::string& path);
+	//Puts the images that finished decoding in the atlas, call it once per frame from the OpenGL thread
+	void Update();
+
+	//False until the icon is in the atlas, and forever when it could not be loaded
+	bool IsIconReady(int iconId) const;
+	//In pixels
+	Point2f GetIconSize(int iconId) const;
+
+	//Icons that are not ready yet are skipped
+	void QueueIcon(int iconId, const Rectf& dstRect);
+	void Flush();
+
+private:
+	static constexpr int m_AtlasSize{ 512 };
+
+	struct Icon
+	{
+		bool isReady{ false };
+		float width{}, height{};
+		//Texture coordinates, the top of the atlas is 0 like the surfaces it came from
+		float texLeft{}, texRight{}, texTop{}, texBottom{};
+	};
+
+	struct DecodedImage
+	{
+		int iconId;
+		SDL_Surface* pSurface; //RGBA32, nullptr when the file could not be loaded
+	};
+
+	std::vector<Icon> m_Icons{};
+	std::map<std::string, int> m_IconIds{};
+
+	//Where the next icon goes, the atlas is filled in rows
+	GLuint m_AtlasTextureId{};
+	int m_NextX{}, m_NextY{}, m_RowHeight{};
+
+	std::mutex m_DecodedMutex{};
+	std::vector<DecodedImage> m_DecodedImages{}; //Guarded by the mutex
+	std::vector<DecodedImage> m_ImagesToPack{};
+
+	//Queued quads, 4 vertices each
+	std::vector<float> m_Vertices{};
+	std::vector<float> m_TexCoords{};
+
+	//Last so it is destroyed first, no decode can finish after the rest of the manager is gone
+	ThreadPool m_Loader{ 1 };
+
+	void CreateAtlas();
+	void PackImage(const DecodedImage& image);
+};
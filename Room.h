@@ -1,6 +1,14 @@
 #pragma once
-#include "Texture.h"
-#include "pch.h"
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cstdlib>
+#include <vector>
+
+#include "MathHelpers.h"
+#include "RoomStore.h"
+#include "SpatialHash.h"
+#include "utils.h"
 
 #define RANDOM_POSITION
 
@@ -27,153 +35,265 @@ struct Hallway
 	int hallwaySize{ 6 };
 };
 
-class Room
+//Broadphase for the room separation, kept around so it does not have to allocate every step
+struct RoomGrid
 {
-public:
-	Room() = default;
-	Room(float winWidth, float winHeight, int ID)
-		:m_WindowWidth{ winWidth },
-		m_WindowHeight{ winHeight },
-		m_RoomID{ID},
-		m_RoomType{DEFAULT}
-	{
-		Initialize();
-	}
-	~Room() = default;
+	SpatialHash hash{};
+	std::vector<Point2f> positions{};
+	std::vector<int> nearbyRooms{};
+	std::vector<Vector2f> displacements{};
+};
 
-	Room operator=(const Room& room) { return *this; }
+//What the separation solver carries from one iteration to the next, so it can be stopped and picked up again
+struct SeparationState
+{
+	float fleeStep{ 0.5f };
+	float previousOverlapDepth{ FLT_MAX };
+	int leastOverlaps{ INT_MAX };
+	int iterationsSinceImprovement{};
+
+	//Where an iteration that is split up over several calls got to, nextRoom is 0 when no iteration is going on
+	int nextRoom{};
+	int numOfOverlaps{};
+	float overlapDepth{};
+};
 
-	void Initialize()
-	{
-		m_Colour = Color4f{ float(rand() % 101) / 100, float(rand() % 101) / 100,
-		float(rand() % 101) / 100 ,float(rand() % 101) / 100 };
-		const float width{ float((rand() % m_MinSize) + m_MaxSize - m_MinSize) };
-		const float height{ float((rand() % m_MinSize) + m_MaxSize - m_MinSize) };
+//Everything that is done with the rooms of a RoomStore, the rooms themselves only exist as data in the store
+class Room final
+{
+public:
+	Room() = delete;
 
-		m_Area = width * height;
+	//The spawn area is only needed to place the rooms, it is not stored
+	static void SpawnRooms(RoomStore& rooms, int numOfRooms, float spawnWidth, float spawnHeight, Pcg32& random)
+	{
+		rooms.Reserve(rooms.GetSize() + numOfRooms);
+		for (int i{}; i < numOfRooms; ++i)
+		{
+			const float width{ float(random.NextInt(m_MinSize) + m_MaxSize - m_MinSize) };
+			const float height{ float(random.NextInt(m_MinSize) + m_MaxSize - m_MinSize) };
 
 #ifdef RANDOM_POSITION
 
-		const float centerY{ (m_WindowHeight / 2.f) + m_Rect.height / 2.f};
-		const float randY{ float(rand() % int(centerY - 10) - 20) };
+			const float centerY{ spawnHeight / 2.f };
+			const float randY{ float(random.NextInt(int(centerY - 10)) - 20) };
 
-		m_Position = Point2f{ float(rand() % int(m_WindowWidth)), randY };
+			const Point2f position{ float(random.NextInt(int(spawnWidth))), randY };
 #else
-		m_Position.x = m_WindowWidth;
-		m_Position.y = m_WindowHeight;
+			const Point2f position{ spawnWidth, spawnHeight };
 #endif
 
-		//todo add height above centerY to make them spawn at the center.
-		m_Rect = Rectf{ m_Position.x, m_Position.y, width, height };
+			//todo add height above centerY to make them spawn at the center.
+			rooms.Add(position.x, position.y, width, height, rooms.GetSize());
+		}
 	}
 
-	void Draw() const
+	//Width of the white border the rooms are drawn with
+	static constexpr float GetOutlineThickness() { return m_MinSize / 9.f; }
+
+	static void SeparateRooms(RoomStore& rooms, float roomTightness, RoomGrid& grid)
 	{
+		constexpr float roomGap{ 15 };
+		const float fleeRange{ roomTightness * m_MaxSize + roomGap};
+		constexpr float fleeSpeed{ 10 };
 
-		utils::SetColor(Color4f{0.152f, 0.15f, 0.15f, 1.f});
-		utils::FillRect(m_Rect);
-		if (m_RoomType == BOSS)
+		//The flee range is bigger than a room, so with cells that big only the neighbouring cells can hold rooms to flee from
+		BuildRoomGrid(rooms, fleeRange, grid);
+		grid.displacements.assign(rooms.GetSize(), Vector2f{});
+
+		for (int roomIdx{}; roomIdx < rooms.GetSize(); ++roomIdx)
 		{
-			const Texture bossIconTexture{ "Assets/boss_icon.png" };
-			bossIconTexture.Draw(Rectf{m_Rect.left + m_Rect.width / 2.f - bossIconTexture.GetWidth() / 2.f, 
-				m_Rect.bottom + m_Rect.height / 2.f - bossIconTexture.GetHeight()	/ 2.f,
-				bossIconTexture.GetWidth(), bossIconTexture.GetHeight()});
-		}
+			const Rectf rect{ rooms.GetRect(roomIdx) };
 
-		utils::SetColor(Color4f{ 1,1,1,1 });
-		utils::DrawRect(Rectf{ m_Rect.left + m_OutlineThickness / 2.f, m_Rect.bottom + m_OutlineThickness / 2.f ,
-			m_Rect.width - m_OutlineThickness / 2.f , m_Rect.height - m_OutlineThickness / 2.f }, m_OutlineThickness / 2.f);
-	}
+			FindNearbyRooms(roomIdx, grid);
+			for (const int roomToEvadeIdx : grid.nearbyRooms)
+			{
+				if (roomToEvadeIdx == roomIdx) continue;
+				Vector2f fleeVector = Vector2f{ grid.positions[roomIdx] } - Vector2f{ grid.positions[roomToEvadeIdx] };
+				//Rooms with the same center have no direction to flee in, split them up sideways
+				if (fleeVector.Length() < 0.001f) fleeVector = Vector2f{ rooms.GetId(roomIdx) < rooms.GetId(roomToEvadeIdx) ? -1.f : 1.f, 0.f };
+				const float distance{ fleeVector.Length() };
+				//Overlapping rooms can have their centers further apart than the flee range when they overlap diagonally
+				if (distance < fleeRange || utils::IsOverlapping(rect, rooms.GetRect(roomToEvadeIdx)))
+				{
+					const Vector2f fleeVectorNormal = fleeVector.Normalized();
 
-	void Update()
-	{
-		//Make the rectangle dependant on the position
-		m_Rect.left = m_Position.x;
-		m_Rect.bottom = m_Position.y;
+					/*fleeVector *= fleeSpeed; //This option scatters them more
+					grid.displacements[roomIdx] += fleeVector;*/
+					grid.displacements[roomIdx] += fleeVectorNormal * fleeSpeed;
+				}
+			}
+		}
+
+		//Every room fled from where the others were at the start of the step, so they only move once all of them are done
+		for (int roomIdx{}; roomIdx < rooms.GetSize(); ++roomIdx)
+			rooms.Move(roomIdx, grid.displacements[roomIdx].x, grid.displacements[roomIdx].y);
 	}
 
-	//Helper Functions
-	float GetArea() const { return m_Area; }
-	//Returns the center of the room
-	Point2f GetPosition() const
+	//Runs SolveSeparationStep until no rooms overlap or the cap is hit, returns how many iterations moved rooms
+	static int SolveSeparation(RoomStore& rooms, float roomTightness, int maxIterations, RoomGrid& grid)
 	{
-		return Point2f{ m_Rect.left + m_Rect.width / 2.f, m_Rect.bottom + m_Rect.height / 2.f };
+		SeparationState state{};
+		for (int iteration{}; iteration < maxIterations; ++iteration)
+		{
+			if (!SolveSeparationStep(rooms, roomTightness, state, grid)) return iteration;
+		}
+		return maxIterations;
 	}
-	Rectf GetRect() const { return m_Rect; }
 
-	int GetId() const { return  m_RoomID; }
-
-	static void FindBiggestRoom(const Room& r1, const Room& r2, Room& roomOut)
+	//One iteration of the separation solver, returns false without moving anything once no rooms overlap anymore
+	static bool SolveSeparationStep(RoomStore& rooms, float roomTightness, SeparationState& state, RoomGrid& grid)
 	{
-		if (r1.GetArea() >= r2.GetArea()) roomOut = r1;
-		else roomOut = r2;
+		bool hasMovedRooms{};
+		while (!ContinueSeparationStep(rooms, roomTightness, state, grid, INT_MAX, hasMovedRooms)) {}
+		return hasMovedRooms;
 	}
 
-	static void SeparateRooms(std::vector<Room*> rooms, float roomTightness)
+	//SolveSeparationStep split up, every call pushes at most maxRooms rooms. Returns true once the iteration is finished,
+	//hasMovedRooms then says whether the rooms moved. The pushes all use where the rooms were at the start of the iteration,
+	//so the rooms only move at the very end and splitting it up does not change the result
+	static bool ContinueSeparationStep(RoomStore& rooms, float roomTightness, SeparationState& state, RoomGrid& grid, int maxRooms, bool& hasMovedRooms)
 	{
 		constexpr float roomGap{ 15 };
-		const float fleeRange{ roomTightness * m_MaxSize + roomGap};
-		constexpr float fleeSpeed{ 10 };
+		const float fleeRange{ roomTightness * m_MaxSize + roomGap };
+		const float halfGap{ roomTightness * roomGap / 2.f };
+		const float maxMove{ fleeRange / 2.f };
+		constexpr int stallIterations{ 32 };
+
+		hasMovedRooms = false;
+		if (state.nextRoom == 0)
+		{
+			BuildRoomGrid(rooms, fleeRange, grid);
+			grid.displacements.assign(rooms.GetSize(), Vector2f{});
+			state.numOfOverlaps = 0;
+			state.overlapDepth = 0.f;
+		}
 
-		for (const auto& room : rooms)
+		const int endRoom{ rooms.GetSize() - state.nextRoom > maxRooms ? state.nextRoom + maxRooms : rooms.GetSize() };
+		for (int roomIdx{ state.nextRoom }; roomIdx < endRoom; ++roomIdx)
 		{
-			for (const auto& roomToEvade : rooms)
+			const Rectf rect{ rooms.GetRect(roomIdx) };
+			Vector2f& displacement{ grid.displacements[roomIdx] };
+
+			FindNearbyRooms(roomIdx, grid);
+			for (const int roomToEvadeIdx : grid.nearbyRooms)
 			{
-				if (room == roomToEvade) continue;
-				Vector2f fleeVector = Vector2f {room->GetPosition() }- Vector2f{roomToEvade->GetPosition()};
+				if (roomToEvadeIdx == roomIdx) continue;
+
+				Vector2f fleeVector{ Vector2f{ grid.positions[roomIdx] } - Vector2f{ grid.positions[roomToEvadeIdx] } };
+				//Rooms with the same center have no direction to flee in, split them up sideways
+				if (fleeVector.Length() < 0.001f) fleeVector = Vector2f{ rooms.GetId(roomIdx) < rooms.GetId(roomToEvadeIdx) ? -1.f : 1.f, 0.f };
 				const float distance{ fleeVector.Length() };
-				if (distance < fleeRange)
-				{
-					const Vector2f fleeVectorNormal = fleeVector.Normalized();
 
-					/*fleeVector *= fleeSpeed; //This option scatters them more
-					room->m_Position += fleeVector;*/
-					room->m_Position += fleeVectorNormal * fleeSpeed;
-					room->m_IsFleeing = true;
-				}
-				else
+				//Grow both rooms by half of the gap, when those overlap the rooms are too close
+				const Rectf rectToEvade{ rooms.GetRect(roomToEvadeIdx) };
+				const float overlapX{ std::min(rect.left + rect.width, rectToEvade.left + rectToEvade.width)
+					- std::max(rect.left, rectToEvade.left) + 2.f * halfGap };
+				const float overlapY{ std::min(rect.bottom + rect.height, rectToEvade.bottom + rectToEvade.height)
+					- std::max(rect.bottom, rectToEvade.bottom) + 2.f * halfGap };
+				if (overlapX > 0.f && overlapY > 0.f)
 				{
-					room->m_IsFleeing = false;
+					//Both rooms move half of the way out along the shallowest axis, plus a little to not end up exactly on the gap
+					constexpr float margin{ 0.01f };
+					if (overlapX < overlapY) displacement.x += (fleeVector.x < 0.f ? -1.f : 1.f) * (overlapX / 2.f + margin);
+					else displacement.y += (fleeVector.y < 0.f ? -1.f : 1.f) * (overlapY / 2.f + margin);
+
+					++state.numOfOverlaps;
+					state.overlapDepth += std::min(overlapX, overlapY);
 				}
+
+				if (distance < fleeRange)
+					displacement += fleeVector.Normalized() * ((fleeRange - distance) / 2.f * state.fleeStep);
 			}
 		}
+
+		state.nextRoom = endRoom;
+		if (endRoom < rooms.GetSize()) return false;
+		state.nextRoom = 0;
+
+		if (state.numOfOverlaps == 0) return true;
+
+		//Grow the step while the rooms untangle and shrink it when they start bouncing back and forth
+		if (state.overlapDepth < state.previousOverlapDepth) state.fleeStep = std::min(1.f, state.fleeStep * 1.1f);
+		else state.fleeStep *= 0.7f;
+		state.previousOverlapDepth = state.overlapDepth;
+
+		//When the overlaps stop going down the flee pushes are fighting each other, only resolve the overlaps from here on
+		if (state.numOfOverlaps < state.leastOverlaps)
+		{
+			state.leastOverlaps = state.numOfOverlaps;
+			state.iterationsSinceImprovement = 0;
+		}
+		else if (++state.iterationsSinceImprovement >= stallIterations)
+		{
+			state.fleeStep = 0.f;
+		}
+
+		for (int roomIdx{}; roomIdx < rooms.GetSize(); ++roomIdx)
+		{
+			Vector2f displacement{ grid.displacements[roomIdx] };
+			if (displacement.Length() > maxMove) displacement = displacement.Normalized() * maxMove;
+
+			rooms.Move(roomIdx, displacement.x, displacement.y);
+		}
+
+		hasMovedRooms = true;
+		return true;
+	}
+
+	static bool AreRoomsOverlapping(const RoomStore& rooms, RoomGrid& grid)
+	{
+		BeginOverlapCheck(rooms, grid);
+		return AreRoomsOverlapping(rooms, grid, 0, rooms.GetSize());
+	}
+
+	//AreRoomsOverlapping split up, BeginOverlapCheck once and then the rooms can be checked in ranges
+	static void BeginOverlapCheck(const RoomStore& rooms, RoomGrid& grid)
+	{
+		//Overlapping rooms always have their centers less than the biggest room size apart
+		BuildRoomGrid(rooms, float(m_MaxSize), grid);
 	}
 
-	static bool AreRoomsOverlapping(std::vector<Room*> rooms)
+	static bool AreRoomsOverlapping(const RoomStore& rooms, RoomGrid& grid, int firstRoom, int endRoom)
 	{
-		for (const auto& room : rooms)
+		for (int roomIdx{ firstRoom }; roomIdx < endRoom; ++roomIdx)
 		{
-			for (const auto& roomToCompare : rooms)
+			FindNearbyRooms(roomIdx, grid);
+			for (const int roomToCompareIdx : grid.nearbyRooms)
 			{
-				if (room == roomToCompare) continue;
-				if (utils::IsOverlapping(room->GetRect(), roomToCompare->GetRect()))
+				//Every pair only needs to be checked once
+				if (roomToCompareIdx <= roomIdx) continue;
+				if (utils::IsOverlapping(rooms.GetRect(roomIdx), rooms.GetRect(roomToCompareIdx)))
 					return true;
 			}
 		}
 		return false;
 	}
 
-	static void ConnectRooms(const Room& r1, const Room& r2, std::vector<Hallway>& hallways)
+	static void ConnectRooms(const RoomStore& rooms, int roomIdx1, int roomIdx2, std::vector<Hallway>& hallways, Pcg32& random)
 	{
-		const float smallestX = std::min(r1.GetPosition().x, r2.GetPosition().x);
-		const float smallestY = std::min(r1.GetPosition().y, r2.GetPosition().y);
-		const float biggestX = std::max(r1.GetPosition().x, r2.GetPosition().x);
-		const float biggestY = std::max(r1.GetPosition().y, r2.GetPosition().y);
+		const Point2f center1{ rooms.GetCenter(roomIdx1) };
+		const Point2f center2{ rooms.GetCenter(roomIdx2) };
+
+		const float smallestX = std::min(center1.x, center2.x);
+		const float smallestY = std::min(center1.y, center2.y);
+		const float biggestX = std::max(center1.x, center2.x);
+		const float biggestY = std::max(center1.y, center2.y);
 
 		Point2f commonPointBottom{ biggestX, smallestY };
 		Point2f commonPointTop{ smallestX, biggestY };
 		Point2f commonPoint{};
 
 		//Make sure the common point is not a room, if it is then offset it to the other diagonal
-		if (Vector2f{ r1.GetPosition() } == Vector2f{ biggestX, smallestY } ||
-			Vector2f{ r1.GetPosition() } == Vector2f{ smallestX, biggestY })
+		if (Vector2f{ center1 } == Vector2f{ biggestX, smallestY } ||
+			Vector2f{ center1 } == Vector2f{ smallestX, biggestY })
 		{
 			commonPointBottom = Point2f{ smallestX, smallestY };
 			commonPointTop = Point2f{ biggestX, biggestY };
 		}
 
 		//Make it random weather the rooms will connect from the top or the bottom, since both ways are equally long
-		const int chance{ rand() % 101 };
+		const int chance{ random.NextInt(101) };
 		if (chance > 50) commonPoint = commonPointBottom;
 		else commonPoint = commonPointTop;
 
@@ -187,8 +307,8 @@ public:
 		}
 		else
 		{
-			Hallway hallway1{ Point2f{r1.GetPosition().x, r1.GetPosition().y}, commonPoint };
-			Hallway hallway2{ Point2f{r2.GetPosition().x, r2.GetPosition().y}, commonPoint };
+			Hallway hallway1{ Point2f{center1.x, center1.y}, commonPoint };
+			Hallway hallway2{ Point2f{center2.x, center2.y}, commonPoint };
 
 			for (const auto& hallwayToCheck : hallways)
 				if (hallway1 == hallwayToCheck || hallway2 == hallwayToCheck)
@@ -199,34 +319,25 @@ public:
 		}
 	}
 
-	static bool CompareRoomSize(const Room* a, const Room* b)
+private:
+	static void BuildRoomGrid(const RoomStore& rooms, float cellSize, RoomGrid& grid)
 	{
-		return a->GetArea() < b->GetArea();
-	}
+		grid.positions.clear();
+		for (int roomIdx{}; roomIdx < rooms.GetSize(); ++roomIdx)
+			grid.positions.emplace_back(rooms.GetCenter(roomIdx));
 
-	bool GetIsFleeing() const { return m_IsFleeing; }
+		grid.hash.Build(grid.positions, cellSize);
+	}
 
-	enum SpecialRoomTypes
+	//Sorted by index, so the rooms get pushed in the same order as when checking every room
+	static void FindNearbyRooms(int roomIdx, RoomGrid& grid)
 	{
-		DEFAULT,
-		BOSS
-	};
+		grid.nearbyRooms.clear();
+		grid.hash.Query(grid.positions[roomIdx], grid.nearbyRooms);
 
-	SpecialRoomTypes GetRoomType() const { return m_RoomType; }
-	void SetSpecialRoom(SpecialRoomTypes type) { m_RoomType = type; }
-
-private:
-	Color4f m_Colour{};
-	Rectf m_Rect{};
-	Point2f m_Position{};
-	float m_Area{};
-	int m_RoomID{};
-	float m_OutlineThickness{ m_MinSize / 9.f };
-	bool m_IsFleeing{ false };
+		std::sort(grid.nearbyRooms.begin(), grid.nearbyRooms.end());
+		grid.nearbyRooms.erase(std::unique(grid.nearbyRooms.begin(), grid.nearbyRooms.end()), grid.nearbyRooms.end());
+	}
 
 	static constexpr int m_MinSize{ 30 }, m_MaxSize{ 80 };
-	const int m_WindowBorderEdgeGap{ 20 };
-	const float m_WindowWidth{}, m_WindowHeight{};
-
-	SpecialRoomTypes m_RoomType{DEFAULT};
 };
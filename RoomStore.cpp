@@ -0,0 +1,151 @@
+#include "RoomStore.h"
+
+#include <algorithm>
+
+#include "HilbertCurve.h"
+
+namespace
+{
+	//Puts values[order[i]] at i
+	template<typename T>
+	void ApplyOrder(std::vector<T>& values, const std::vector<int>& order, std::vector<T>& scratch)
+	{
+		scratch.resize(values.size());
+		for (size_t i{}; i < order.size(); ++i)
+			scratch[i] = values[order[i]];
+		values.swap(scratch);
+	}
+}
+
+void RoomStore::Clear()
+{
+	m_Lefts.clear();
+	m_Bottoms.clear();
+	m_Widths.clear();
+	m_Heights.clear();
+	m_Areas.clear();
+	m_Ids.clear();
+	m_Types.clear();
+	m_IsAlive.clear();
+}
+
+void RoomStore::Reserve(int numOfRooms)
+{
+	m_Lefts.reserve(numOfRooms);
+	m_Bottoms.reserve(numOfRooms);
+	m_Widths.reserve(numOfRooms);
+	m_Heights.reserve(numOfRooms);
+	m_Areas.reserve(numOfRooms);
+	m_Ids.reserve(numOfRooms);
+	m_Types.reserve(numOfRooms);
+	m_IsAlive.reserve(numOfRooms);
+}
+
+int RoomStore::Add(float left, float bottom, float width, float height, int id)
+{
+	m_Lefts.emplace_back(left);
+	m_Bottoms.emplace_back(bottom);
+	m_Widths.emplace_back(width);
+	m_Heights.emplace_back(height);
+	m_Areas.emplace_back(width * height);
+	m_Ids.emplace_back(id);
+	m_Types.emplace_back(DEFAULT);
+	m_IsAlive.emplace_back(uint8_t(1));
+
+	return GetSize() - 1;
+}
+
+RoomStore::RoomStore(const RoomStore& other)
+{
+	*this = other;
+}
+
+RoomStore& RoomStore::operator=(const RoomStore& other)
+{
+	if (this == &other) return *this;
+
+	m_Lefts.assign(other.m_Lefts.begin(), other.m_Lefts.end());
+	m_Bottoms.assign(other.m_Bottoms.begin(), other.m_Bottoms.end());
+	m_Widths.assign(other.m_Widths.begin(), other.m_Widths.end());
+	m_Heights.assign(other.m_Heights.begin(), other.m_Heights.end());
+	m_Areas.assign(other.m_Areas.begin(), other.m_Areas.end());
+	m_Ids.assign(other.m_Ids.begin(), other.m_Ids.end());
+	m_Types.assign(other.m_Types.begin(), other.m_Types.end());
+	m_IsAlive.assign(other.m_IsAlive.begin(), other.m_IsAlive.end());
+	return *this;
+}
+
+void RoomStore::SortAlongHilbertCurve()
+{
+	if (m_Ids.empty()) return;
+
+	Point2f minCenter{ GetCenter(0) }, maxCenter{ minCenter };
+	for (int roomIdx{ 1 }; roomIdx < GetSize(); ++roomIdx)
+	{
+		const Point2f center{ GetCenter(roomIdx) };
+		minCenter.x = std::min(minCenter.x, center.x);
+		minCenter.y = std::min(minCenter.y, center.y);
+		maxCenter.x = std::max(maxCenter.x, center.x);
+		maxCenter.y = std::max(maxCenter.y, center.y);
+	}
+
+	const HilbertCurve curve{ minCenter.x, minCenter.y, maxCenter.x, maxCenter.y };
+	curve.CreateOrder(GetSize(), [this](int roomIdx) { return GetCenter(roomIdx); }, 1, m_SortOrder, m_SortKeys);
+	ApplySortOrder();
+}
+
+void RoomStore::KeepSmallest(int numOfRooms)
+{
+	if (numOfRooms >= GetSize()) return;
+
+	m_SortOrder.resize(m_Ids.size());
+	for (int i{}; i < GetSize(); ++i)
+		m_SortOrder[i] = i;
+
+	//Only which rooms make the cut matters, not their order
+	const int firstDeleted{ std::max(numOfRooms, 0) };
+	std::nth_element(m_SortOrder.begin(), m_SortOrder.begin() + firstDeleted, m_SortOrder.end(),
+		[this](int roomA, int roomB) { return IsSmaller(roomA, roomB); });
+
+	for (int i{ firstDeleted }; i < GetSize(); ++i)
+		SetAlive(m_SortOrder[i], false);
+}
+
+int RoomStore::FindBiggestAliveRoom() const
+{
+	int biggestRoomIdx{ -1 };
+	for (int roomIdx{}; roomIdx < GetSize(); ++roomIdx)
+	{
+		if (IsAlive(roomIdx) && (biggestRoomIdx == -1 || IsSmaller(biggestRoomIdx, roomIdx)))
+			biggestRoomIdx = roomIdx;
+	}
+	return biggestRoomIdx;
+}
+
+int RoomStore::FindSmallestDeadRoom() const
+{
+	int smallestRoomIdx{ -1 };
+	for (int roomIdx{}; roomIdx < GetSize(); ++roomIdx)
+	{
+		if (!IsAlive(roomIdx) && (smallestRoomIdx == -1 || IsSmaller(roomIdx, smallestRoomIdx)))
+			smallestRoomIdx = roomIdx;
+	}
+	return smallestRoomIdx;
+}
+
+void RoomStore::ApplySortOrder()
+{
+	ApplyOrder(m_Lefts, m_SortOrder, m_FloatScratch);
+	ApplyOrder(m_Bottoms, m_SortOrder, m_FloatScratch);
+	ApplyOrder(m_Widths, m_SortOrder, m_FloatScratch);
+	ApplyOrder(m_Heights, m_SortOrder, m_FloatScratch);
+	ApplyOrder(m_Areas, m_SortOrder, m_FloatScratch);
+	ApplyOrder(m_Ids, m_SortOrder, m_IntScratch);
+	ApplyOrder(m_Types, m_SortOrder, m_TypeScratch);
+	ApplyOrder(m_IsAlive, m_SortOrder, m_ByteScratch);
+}
+
+int RoomStore::GetNumOfAliveRooms() const
+{
+	return int(std::count(m_IsAlive.begin(), m_IsAlive.end(), uint8_t(1)));
+}
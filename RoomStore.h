@@ -0,0 +1,95 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "structs.h"
+
+//Every room of a dungeon, stored as one array per property so the separation and sorting can stream through them.
+//Deleted rooms stay in the store with their alive flag turned off, so bringing one back is just turning it on again.
+class RoomStore final
+{
+public:
+	enum SpecialRoomTypes : uint8_t
+	{
+		DEFAULT,
+		BOSS
+	};
+
+	RoomStore() = default;
+	//Copies only copy the rooms, not the sort scratch, and reuse the memory that is already there
+	RoomStore(const RoomStore& other);
+	RoomStore& operator=(const RoomStore& other);
+	RoomStore(RoomStore&& other) noexcept = default;
+	RoomStore& operator=(RoomStore&& other) noexcept = default;
+	~RoomStore() = default;
+
+	//Keeps the memory, so refilling the store does not allocate
+	void Clear();
+	void Reserve(int numOfRooms);
+	//Returns the index of the new room
+	int Add(float left, float bottom, float width, float height, int id);
+
+	//Orders the rooms along a Hilbert curve through their centers, so rooms that are close in the store are close in space
+	void SortAlongHilbertCurve();
+	//Turns off every room but the given number of smallest ones, same sized rooms are ordered by id
+	void KeepSmallest(int numOfRooms);
+	//Index of the biggest alive room with the same tie break as KeepSmallest, -1 when no room is alive
+	int FindBiggestAliveRoom() const;
+	//The room KeepSmallest would keep next, -1 when every room is alive
+	int FindSmallestDeadRoom() const;
+
+	int GetSize() const { return int(m_Ids.size()); }
+	int GetNumOfAliveRooms() const;
+
+	float GetLeft(int roomIdx) const { return m_Lefts[roomIdx]; }
+	float GetBottom(int roomIdx) const { return m_Bottoms[roomIdx]; }
+	float GetWidth(int roomIdx) const { return m_Widths[roomIdx]; }
+	float GetHeight(int roomIdx) const { return m_Heights[roomIdx]; }
+	float GetArea(int roomIdx) const { return m_Areas[roomIdx]; }
+	int GetId(int roomIdx) const { return m_Ids[roomIdx]; }
+	SpecialRoomTypes GetType(int roomIdx) const { return m_Types[roomIdx]; }
+	bool IsAlive(int roomIdx) const { return m_IsAlive[roomIdx] != 0; }
+
+	Rectf GetRect(int roomIdx) const
+	{
+		return Rectf{ m_Lefts[roomIdx], m_Bottoms[roomIdx], m_Widths[roomIdx], m_Heights[roomIdx] };
+	}
+	Point2f GetCenter(int roomIdx) const
+	{
+		return Point2f{ m_Lefts[roomIdx] + m_Widths[roomIdx] / 2.f, m_Bottoms[roomIdx] + m_Heights[roomIdx] / 2.f };
+	}
+
+	void Move(int roomIdx, float x, float y)
+	{
+		m_Lefts[roomIdx] += x;
+		m_Bottoms[roomIdx] += y;
+	}
+	void SetAlive(int roomIdx, bool isAlive) { m_IsAlive[roomIdx] = isAlive ? 1 : 0; }
+	void SetType(int roomIdx, SpecialRoomTypes type) { m_Types[roomIdx] = type; }
+
+private:
+	std::vector<float> m_Lefts{};
+	std::vector<float> m_Bottoms{};
+	std::vector<float> m_Widths{};
+	std::vector<float> m_Heights{};
+	std::vector<float> m_Areas{};
+	std::vector<int> m_Ids{};
+	std::vector<SpecialRoomTypes> m_Types{};
+	std::vector<uint8_t> m_IsAlive{};
+
+	//Scratch for sorting
+	std::vector<int> m_SortOrder{};
+	std::vector<uint64_t> m_SortKeys{};
+	std::vector<float> m_FloatScratch{};
+	std::vector<int> m_IntScratch{};
+	std::vector<SpecialRoomTypes> m_TypeScratch{};
+	std::vector<uint8_t> m_ByteScratch{};
+
+	bool IsSmaller(int roomA, int roomB) const
+	{
+		if (m_Areas[roomA] != m_Areas[roomB]) return m_Areas[roomA] < m_Areas[roomB];
+		return m_Ids[roomA] < m_Ids[roomB];
+	}
+	//Puts room m_SortOrder[i] at i
+	void ApplySortOrder();
+};
@@ -0,0 +1,83 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "structs.h"
+
+//Uniform grid that is rebuilt from scratch every time the items move.
+//The cells are hashed into a table that grows with the number of items, so rooms that are spread out far
+//do not need a huge grid. Items are stored sorted by bucket, which keeps a rebuild at two passes over the items.
+class SpatialHash final
+{
+public:
+	SpatialHash() = default;
+
+	//Puts every position in its cell, the index of the position is what queries give back
+	void Build(const std::vector<Point2f>& positions, float cellSize)
+	{
+		m_CellSize = cellSize;
+
+		//At least twice as many buckets as items keeps the collisions low
+		int numOfBuckets{ 1 };
+		while (numOfBuckets < 2 * int(positions.size()))
+			numOfBuckets *= 2;
+		m_BucketMask = numOfBuckets - 1;
+
+		m_BucketStarts.assign(numOfBuckets + 1, 0);
+		m_ItemBuckets.resize(positions.size());
+		m_Items.resize(positions.size());
+
+		//Count the items per bucket
+		for (int i{}; i < int(positions.size()); ++i)
+		{
+			m_ItemBuckets[i] = GetBucket(GetCell(positions[i].x), GetCell(positions[i].y));
+			++m_BucketStarts[m_ItemBuckets[i] + 1];
+		}
+		for (int bucket{}; bucket < numOfBuckets; ++bucket)
+			m_BucketStarts[bucket + 1] += m_BucketStarts[bucket];
+
+		//Place them, m_BucketStarts is used as the write position and shifted back afterwards
+		for (int i{}; i < int(positions.size()); ++i)
+			m_Items[m_BucketStarts[m_ItemBuckets[i]]++] = i;
+		for (int bucket{ numOfBuckets }; bucket > 0; --bucket)
+			m_BucketStarts[bucket] = m_BucketStarts[bucket - 1];
+		m_BucketStarts[0] = 0;
+	}
+
+	//Adds every item in the cell of the position and the 8 cells around it.
+	//Cells can share a bucket, so an item can be added more than once and items from further away can show up as well.
+	void Query(const Point2f& position, std::vector<int>& itemsOut) const
+	{
+		if (m_Items.empty()) return;
+
+		const int cellX{ GetCell(position.x) };
+		const int cellY{ GetCell(position.y) };
+		for (int offsetY{ -1 }; offsetY <= 1; ++offsetY)
+		{
+			for (int offsetX{ -1 }; offsetX <= 1; ++offsetX)
+			{
+				const int bucket{ GetBucket(cellX + offsetX, cellY + offsetY) };
+				for (int i{ m_BucketStarts[bucket] }; i < m_BucketStarts[bucket + 1]; ++i)
+					itemsOut.emplace_back(m_Items[i]);
+			}
+		}
+	}
+
+private:
+	float m_CellSize{ 1.f };
+	int m_BucketMask{};
+	std::vector<int> m_BucketStarts{};
+	std::vector<int> m_ItemBuckets{};
+	std::vector<int> m_Items{};
+
+	int GetCell(float coordinate) const
+	{
+		return int(std::floor(coordinate / m_CellSize));
+	}
+	int GetBucket(int cellX, int cellY) const
+	{
+		const uint32_t hash{ uint32_t(cellX) * 73856093u ^ uint32_t(cellY) * 19349663u };
+		return int(hash & uint32_t(m_BucketMask));
+	}
+};
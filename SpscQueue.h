@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+//Lock-free queue for exactly one thread pushing and one other thread popping.
+//Each side only writes its own index, the other side reads it to know how far it can go.
+template<typename T>
+class SpscQueue final
+{
+public:
+	explicit SpscQueue(size_t capacity)
+		:m_Items(capacity + 1) //One slot stays empty to tell a full queue apart from an empty one
+	{
+	}
+	SpscQueue(const SpscQueue& other) = delete;
+	SpscQueue& operator=(const SpscQueue& other) = delete;
+	SpscQueue(SpscQueue&& other) = delete;
+	SpscQueue& operator=(SpscQueue&& other) = delete;
+	~SpscQueue() = default;
+
+	//Only call from the producing thread, returns false when the queue is full
+	bool TryPush(const T& item)
+	{
+		const size_t tail{ m_Tail.load(std::memory_order_relaxed) };
+		const size_t nextTail{ Next(tail) };
+		if (nextTail == m_Head.load(std::memory_order_acquire)) return false;
+
+		m_Items[tail] = item;
+		m_Tail.store(nextTail, std::memory_order_release);
+		return true;
+	}
+
+	//Only call from the consuming thread, returns false when the queue is empty
+	bool TryPop(T& itemOut)
+	{
+		const size_t head{ m_Head.load(std::memory_order_relaxed) };
+		if (head == m_Tail.load(std::memory_order_acquire)) return false;
+
+		itemOut = m_Items[head];
+		m_Head.store(Next(head), std::memory_order_release);
+		return true;
+	}
+
+	bool IsEmpty() const
+	{
+		return m_Head.load(std::memory_order_acquire) == m_Tail.load(std::memory_order_acquire);
+	}
+
+private:
+	std::vector<T> m_Items;
+
+	//On separate cache lines so both threads do not keep stealing the line from each other
+	alignas(64) std::atomic<size_t> m_Head{ 0 };
+	alignas(64) std::atomic<size_t> m_Tail{ 0 };
+
+	size_t Next(size_t index) const
+	{
+		return index + 1 == m_Items.size() ? 0 : index + 1;
+	}
+};
@@ -0,0 +1,476 @@
+//Checks that the different ways the generator has to build the same thing agree with each other.
+//Exits with 1 when one of the checks fails, ctest runs it.
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "DungeonGenerator.h"
+#include "InCircleKernel.h"
+#include "ThreadPool.h"
+
+int g_NumOfFailures{};
+
+void Check(bool isPassed, const std::string& name)
+{
+	if (isPassed)
+	{
+		std::cout << "passed " << name << std::endl;
+		return;
+	}
+
+	std::cout << "FAILED " << name << std::endl;
+	++g_NumOfFailures;
+}
+
+enum class PointLayout
+{
+	random,
+	grid, //Every square of four points is cocircular
+	roomCenters, //Halves like the centers of rooms, with a lot of cocircular and collinear points
+	lines //Rows of collinear points
+};
+
+Point2f CreatePoint(PointLayout layout, int pointIdx, Pcg32& random)
+{
+	switch (layout)
+	{
+	case PointLayout::random:
+	{
+		const float x{ float(random.Next()) / 4294967296.f * 1000.f };
+		return Point2f{ x, float(random.Next()) / 4294967296.f * 1000.f };
+	}
+	case PointLayout::grid:
+		return Point2f{ float(pointIdx % 64) * 10.f, float(pointIdx / 64) * 10.f };
+	case PointLayout::roomCenters:
+	{
+		const float x{ float(random.NextInt(400)) + float(random.NextInt(5)) * 0.5f };
+		return Point2f{ x, float(random.NextInt(400)) + float(random.NextInt(5)) * 0.5f };
+	}
+	case PointLayout::lines:
+	{
+		const float x{ float(random.NextInt(1000)) };
+		return Point2f{ x, float(random.NextInt(4)) * 100.f };
+	}
+	}
+	return Point2f{};
+}
+
+std::vector<Vertex> CreatePoints(PointLayout layout, int numOfPoints, Pcg32& random)
+{
+	std::vector<Vertex> points{};
+	for (int pointIdx{}; pointIdx < numOfPoints; ++pointIdx)
+		points.emplace_back(CreatePoint(layout, pointIdx, random), pointIdx);
+	return points;
+}
+
+//A point of the layout that is not on top of one of the points yet.
+//An edit that puts a point on top of another can keep a different one of the two than a rebuild, so the edit checks stay clear of that
+Point2f CreateFreePoint(PointLayout layout, const std::vector<Vertex>& points, Pcg32& random)
+{
+	while (true)
+	{
+		//The grid gets a random spot on a grid twice as big, so there is always room left
+		const Point2f point{ CreatePoint(layout, random.NextInt(64 * 128), random) };
+		const bool isTaken{ std::any_of(points.begin(), points.end(), [&point](const Vertex& other) { return other.x == point.x && other.y == point.y; }) };
+		if (!isTaken) return point;
+	}
+}
+
+const char* GetLayoutName(PointLayout layout)
+{
+	switch (layout)
+	{
+	case PointLayout::random: return "random";
+	case PointLayout::grid: return "grid";
+	case PointLayout::roomCenters: return "room centers";
+	case PointLayout::lines: return "lines";
+	}
+	return "unknown";
+}
+
+//The rooms of every edge with the lowest one first, sorted
+std::vector<std::pair<int, int>> GetEdgeRooms(const std::vector<Connection>& edges)
+{
+	std::vector<std::pair<int, int>> edgeRooms{};
+	for (const auto& edge : edges)
+	{
+		const int roomA{ edge.start.roomConnectionID }, roomB{ edge.end.roomConnectionID };
+		edgeRooms.emplace_back(std::min(roomA, roomB), std::max(roomA, roomB));
+	}
+	std::sort(edgeRooms.begin(), edgeRooms.end());
+	return edgeRooms;
+}
+
+std::vector<std::pair<int, int>> Triangulate(const std::vector<Vertex>& points, ThreadPool* pPool)
+{
+	Graph graph{};
+	graph.SetPoints(points);
+	if (pPool) graph.CalculateTriangulationParallel(*pPool);
+	else graph.CalculateTriangulation();
+	graph.CalculateMST();
+	return GetEdgeRooms(graph.GetEdges());
+}
+
+bool IsSameDungeon(const DungeonResult& dungeonA, const DungeonResult& dungeonB)
+{
+	if (dungeonA.rooms.GetSize() != dungeonB.rooms.GetSize() || dungeonA.hallways.size() != dungeonB.hallways.size()) return false;
+
+	for (int roomIdx{}; roomIdx < dungeonA.rooms.GetSize(); ++roomIdx)
+	{
+		if (dungeonA.rooms.IsAlive(roomIdx) != dungeonB.rooms.IsAlive(roomIdx)) return false;
+		if (dungeonA.rooms.GetType(roomIdx) != dungeonB.rooms.GetType(roomIdx)) return false;
+		if (dungeonA.rooms.GetLeft(roomIdx) != dungeonB.rooms.GetLeft(roomIdx)) return false;
+		if (dungeonA.rooms.GetBottom(roomIdx) != dungeonB.rooms.GetBottom(roomIdx)) return false;
+	}
+	for (size_t hallwayIdx{}; hallwayIdx < dungeonA.hallways.size(); ++hallwayIdx)
+	{
+		const Hallway& hallwayA{ dungeonA.hallways[hallwayIdx] };
+		const Hallway& hallwayB{ dungeonB.hallways[hallwayIdx] };
+		if (hallwayA.startingPoint.x != hallwayB.startingPoint.x || hallwayA.startingPoint.y != hallwayB.startingPoint.y) return false;
+		if (hallwayA.endPoint.x != hallwayB.endPoint.x || hallwayA.endPoint.y != hallwayB.endPoint.y) return false;
+	}
+	return GetEdgeRooms(dungeonA.roomConnections) == GetEdgeRooms(dungeonB.roomConnections);
+}
+
+//The divide and conquer has to give the exact edges of the mesh, including the ones along the outside and between cocircular points
+//Every circle the batch is sure about has the sign InCircle gives, for every number of circles in a batch
+void TestInCircleKernel()
+{
+	for (const PointLayout layout : { PointLayout::random, PointLayout::grid, PointLayout::roomCenters, PointLayout::lines })
+	{
+		Pcg32 random{ 7, 0 };
+		const std::vector<Vertex> points{ CreatePoints(layout, 200, random) };
+
+		utils::CircleBatch batch{};
+		bool isCorrect{ true };
+		int numOfUncertain{};
+		for (int batchIdx{}; batchIdx < 400; ++batchIdx)
+		{
+			const int numOfCircles{ batchIdx % utils::g_CirclesPerBatch + 1 };
+			for (int circleIdx{}; circleIdx < numOfCircles; ++circleIdx)
+			{
+				Vertex a{ points[random.NextInt(200)] }, b{ points[random.NextInt(200)] };
+				const Vertex& c{ points[random.NextInt(200)] };
+				if (utils::Orient2d(a.x, a.y, b.x, b.y, c.x, c.y) < 0.0) std::swap(a, b);
+
+				batch.ax[circleIdx] = a.x;
+				batch.ay[circleIdx] = a.y;
+				batch.bx[circleIdx] = b.x;
+				batch.by[circleIdx] = b.y;
+				batch.cx[circleIdx] = c.x;
+				batch.cy[circleIdx] = c.y;
+			}
+
+			for (const Vertex& point : points)
+			{
+				unsigned int uncertainMask{};
+				const unsigned int insideMask{ utils::PointInCircles(point.x, point.y, batch, numOfCircles, uncertainMask) };
+				if ((insideMask | uncertainMask) >> numOfCircles != 0) isCorrect = false;
+
+				for (int circleIdx{}; circleIdx < numOfCircles; ++circleIdx)
+				{
+					const unsigned int circleBit{ 1u << circleIdx };
+					if ((uncertainMask & circleBit) != 0)
+					{
+						++numOfUncertain;
+						continue;
+					}
+
+					const double det{ utils::InCircle(batch.ax[circleIdx], batch.ay[circleIdx], batch.bx[circleIdx], batch.by[circleIdx],
+						batch.cx[circleIdx], batch.cy[circleIdx], point.x, point.y) };
+					if ((det > 0.0) != ((insideMask & circleBit) != 0) || det == 0.0) isCorrect = false;
+				}
+			}
+		}
+
+		Check(isCorrect, std::string{ "in circle batches against InCircle, " } + GetLayoutName(layout));
+		//Points on the circle itself always have to be left for the exact predicates
+		if (layout != PointLayout::random)
+			Check(numOfUncertain > 0, std::string{ "in circle batches leave cocircular points to InCircle, " } + GetLayoutName(layout));
+	}
+}
+
+void TestParallelTriangulation()
+{
+	ThreadPool pool{ 4 };
+	Pcg32 random{ 1, 0 };
+
+	for (const PointLayout layout : { PointLayout::random, PointLayout::grid, PointLayout::roomCenters, PointLayout::lines })
+	{
+		for (const int numOfPoints : { 3, 10, 100, 5000 })
+		{
+			const std::vector<Vertex> points{ CreatePoints(layout, numOfPoints, random) };
+			Check(Triangulate(points, nullptr) == Triangulate(points, &pool),
+				std::string{ "parallel triangulation, " } + GetLayoutName(layout) + ", " + std::to_string(numOfPoints) + " points");
+		}
+	}
+}
+
+//Editing a finished triangulation a point at a time has to end up with the edges of a triangulation made from scratch
+void TestEditedTriangulation()
+{
+	Pcg32 random{ 2, 0 };
+
+	for (const PointLayout layout : { PointLayout::random, PointLayout::grid, PointLayout::roomCenters, PointLayout::lines })
+	{
+		std::vector<Vertex> points{};
+		for (int pointIdx{}; pointIdx < 300; ++pointIdx)
+			points.emplace_back(CreateFreePoint(layout, points, random), pointIdx);
+
+		Graph graph{};
+		graph.SetPoints(points);
+		graph.CalculateTriangulation();
+		graph.CalculateMST();
+
+		int nextRoom{ int(points.size()) };
+		bool isSame{ true };
+		for (int editIdx{ 1 }; editIdx <= 400; ++editIdx)
+		{
+			const int numOfPoints{ int(graph.GetPoints().size()) };
+			const int edit{ random.NextInt(3) };
+			if (edit == 0 || numOfPoints <= 3)
+			{
+				graph.InsertPoint(Vertex{ CreateFreePoint(layout, graph.GetPoints(), random), nextRoom++ });
+			}
+			else if (edit == 1)
+			{
+				graph.RemovePoint(random.NextInt(numOfPoints));
+			}
+			else
+			{
+				const int pointIdx{ random.NextInt(numOfPoints) };
+				const Point2f position{ CreateFreePoint(layout, graph.GetPoints(), random) };
+				graph.MovePoint(pointIdx, position.x, position.y);
+			}
+
+			if (editIdx % 50 != 0) continue;
+			graph.CalculateMST();
+			isSame = isSame && GetEdgeRooms(graph.GetEdges()) == Triangulate(graph.GetPoints(), nullptr);
+		}
+		Check(isSame, std::string{ "edited triangulation, " } + GetLayoutName(layout));
+	}
+}
+
+//The lists CalculateMST gives, with the rooms of every edge where they are right now.
+//An edited graph patches its lists in place, so they are compared sorted on weight and rooms
+bool IsSameEdgeList(std::vector<Connection> edgesA, std::vector<Connection> edgesB)
+{
+	if (edgesA.size() != edgesB.size()) return false;
+
+	auto IsLighter = [](const Connection& edgeA, const Connection& edgeB)
+	{
+		if (edgeA.weight != edgeB.weight) return edgeA.weight < edgeB.weight;
+		if (edgeA.start.roomConnectionID != edgeB.start.roomConnectionID) return edgeA.start.roomConnectionID < edgeB.start.roomConnectionID;
+		return edgeA.end.roomConnectionID < edgeB.end.roomConnectionID;
+	};
+	std::sort(edgesA.begin(), edgesA.end(), IsLighter);
+	std::sort(edgesB.begin(), edgesB.end(), IsLighter);
+
+	for (size_t edgeIdx{}; edgeIdx < edgesA.size(); ++edgeIdx)
+	{
+		const Connection& edgeA{ edgesA[edgeIdx] };
+		const Connection& edgeB{ edgesB[edgeIdx] };
+		if (!(edgeA == edgeB) || edgeA.weight != edgeB.weight) return false;
+		if (edgeA.start.roomConnectionID != edgeB.start.roomConnectionID || edgeA.end.roomConnectionID != edgeB.end.roomConnectionID) return false;
+	}
+	return true;
+}
+
+//After edits the spanning tree only follows the edges that changed, it has to end up with the lists Kruskal gives from scratch
+//and the same room connections.
+//A few edits at a time between the checks, and one big batch that changes most of the tree at once
+void TestEditedSpanningTree()
+{
+	Pcg32 random{ 3, 0 };
+
+	for (const PointLayout layout : { PointLayout::random, PointLayout::roomCenters })
+	{
+		std::vector<Vertex> points{};
+		for (int pointIdx{}; pointIdx < 300; ++pointIdx)
+			points.emplace_back(CreateFreePoint(layout, points, random), pointIdx);
+
+		Graph graph{}, freshGraph{};
+		graph.SetPoints(points);
+		graph.CalculateTriangulation();
+		graph.CalculateMST();
+
+		int nextRoom{ int(points.size()) };
+		bool isSame{ true };
+		for (const int numOfEditsPerCheck : { 1, 5, 400 })
+		{
+			for (int checkIdx{}; checkIdx < 20; ++checkIdx)
+			{
+				for (int editIdx{}; editIdx < numOfEditsPerCheck; ++editIdx)
+				{
+					const int numOfPoints{ int(graph.GetPoints().size()) };
+					const int edit{ random.NextInt(4) };
+					if (edit == 0 || numOfPoints <= 3)
+					{
+						graph.InsertPoint(Vertex{ CreateFreePoint(layout, graph.GetPoints(), random), nextRoom++ });
+					}
+					else if (edit == 1)
+					{
+						graph.RemovePoint(random.NextInt(numOfPoints));
+					}
+					else
+					{
+						//Small moves as well, they keep most of the edges but change their lengths
+						const int pointIdx{ random.NextInt(numOfPoints) };
+						const std::vector<Vertex>& graphPoints{ graph.GetPoints() };
+						Point2f position{ graphPoints[pointIdx].x + 0.25f, graphPoints[pointIdx].y };
+						const bool isTaken{ std::any_of(graphPoints.begin(), graphPoints.end(),
+							[&position](const Vertex& other) { return other.x == position.x && other.y == position.y; }) };
+						if (edit == 2 || isTaken) position = CreateFreePoint(layout, graphPoints, random);
+						graph.MovePoint(pointIdx, position.x, position.y);
+					}
+				}
+				//The same seed every time, so after the first check the edits keep the room connections up to date
+				Pcg32 connectionRandom{ 5, 0 }, freshConnectionRandom{ 5, 0 };
+				graph.CalculateMST();
+				graph.FillRoomConnections(connectionRandom);
+
+				freshGraph.SetPoints(graph.GetPoints());
+				freshGraph.CalculateTriangulation();
+				freshGraph.CalculateMST();
+				freshGraph.FillRoomConnections(freshConnectionRandom);
+				isSame = isSame && IsSameEdgeList(graph.GetMSTEdges(), freshGraph.GetMSTEdges())
+					&& IsSameEdgeList(graph.GetDeletedEdges(), freshGraph.GetDeletedEdges())
+					&& IsSameEdgeList(graph.GetEdges(), freshGraph.GetEdges())
+					&& IsSameEdgeList(graph.GetRoomConnections(), freshGraph.GetRoomConnections());
+			}
+		}
+		Check(isSame, std::string{ "edited spanning tree against Kruskal, " } + GetLayoutName(layout));
+	}
+}
+
+//The rooms and the graph of two dungeons, not the hallways. An edited graph keeps its room connections in a different order,
+//and the router lays the hallways in the order of the connections
+bool IsSameDungeonGraph(const DungeonResult& dungeonA, const DungeonResult& dungeonB)
+{
+	if (dungeonA.rooms.GetSize() != dungeonB.rooms.GetSize()) return false;
+	for (int roomIdx{}; roomIdx < dungeonA.rooms.GetSize(); ++roomIdx)
+	{
+		if (dungeonA.rooms.GetLeft(roomIdx) != dungeonB.rooms.GetLeft(roomIdx)) return false;
+		if (dungeonA.rooms.GetBottom(roomIdx) != dungeonB.rooms.GetBottom(roomIdx)) return false;
+	}
+	return GetEdgeRooms(dungeonA.delaunayEdges) == GetEdgeRooms(dungeonB.delaunayEdges)
+		&& GetEdgeRooms(dungeonA.mstEdges) == GetEdgeRooms(dungeonB.mstEdges)
+		&& GetEdgeRooms(dungeonA.roomConnections) == GetEdgeRooms(dungeonB.roomConnections);
+}
+
+//Changing the number of rooms of a finished dungeon has to give the graph that gets generated with that number from the start
+void TestEditedNumOfRooms()
+{
+	DungeonGenerator editedGenerator{}, generator{};
+	for (const unsigned int seed : { 1u, 2u, 3u })
+	{
+		DungeonParams params{};
+		params.minimumNumOfRooms = 40;
+		params.numOfRoomsToGen = 100;
+		params.seed = seed;
+
+		editedGenerator.Reset(params);
+		editedGenerator.Generate();
+		for (const int numOfRooms : { 60, 25, 41 })
+		{
+			editedGenerator.SetMinimumNumOfRooms(numOfRooms);
+			editedGenerator.Generate();
+
+			params.minimumNumOfRooms = numOfRooms;
+			generator.Reset(params);
+			Check(IsSameDungeonGraph(editedGenerator.GetResult(), generator.Generate()),
+				"minimum number of rooms edited to " + std::to_string(numOfRooms) + ", seed " + std::to_string(seed));
+		}
+	}
+}
+
+//Whether a hallway of the dungeon goes all the way through the rect, like the generator checks for the deleted rooms
+bool IsCrossed(const DungeonResult& dungeon, const Rectf& rect)
+{
+	float minFlt{}, maxFlt{};
+	return std::any_of(dungeon.hallways.begin(), dungeon.hallways.end(),
+		[&](const Hallway& hallway) { return utils::IntersectRectLine(rect, hallway.startingPoint, hallway.endPoint, minFlt, maxFlt); });
+}
+
+//Whether a hallway starts or ends in the rect
+bool IsReached(const DungeonResult& dungeon, const Rectf& rect)
+{
+	return std::any_of(dungeon.hallways.begin(), dungeon.hallways.end(),
+		[&](const Hallway& hallway) { return utils::IsPointInRect(hallway.startingPoint, rect) || utils::IsPointInRect(hallway.endPoint, rect); });
+}
+
+//After edits only the changed connections get routed again, the dungeon still has to be whole: every connection reaches both of its rooms
+//and the deleted rooms that are back are exactly the ones with a hallway through them
+void TestEditedHallways()
+{
+	DungeonGenerator generator{};
+	Pcg32 random{ 11, 0 };
+	for (const bool routeHallways : { true, false })
+	{
+		DungeonParams params{};
+		params.minimumNumOfRooms = 60;
+		params.seed = 4;
+		params.routeHallways = routeHallways;
+		generator.Reset(params);
+		generator.Generate();
+
+		bool isWhole{ true };
+		for (int editIdx{}; editIdx < 40; ++editIdx)
+		{
+			if (editIdx % 8 == 7) generator.SetMinimumNumOfRooms(40 + random.NextInt(40));
+			else generator.MoveRoom(random.NextInt(generator.GetResult().rooms.GetSize()), float(random.NextInt(81) - 40), float(random.NextInt(81) - 40));
+			if (editIdx % 2 == 0) continue;
+
+			const DungeonResult& dungeon{ generator.Generate() };
+			std::vector<bool> isGraphRoom(dungeon.rooms.GetSize(), false);
+			for (const auto& connection : dungeon.roomConnections)
+			{
+				isGraphRoom[connection.start.roomConnectionID] = isGraphRoom[connection.end.roomConnectionID] = true;
+				isWhole = isWhole && IsReached(dungeon, dungeon.rooms.GetRect(connection.start.roomConnectionID))
+					&& IsReached(dungeon, dungeon.rooms.GetRect(connection.end.roomConnectionID));
+			}
+			for (int roomIdx{}; roomIdx < dungeon.rooms.GetSize(); ++roomIdx)
+			{
+				if (!isGraphRoom[roomIdx])
+					isWhole = isWhole && dungeon.rooms.IsAlive(roomIdx) == IsCrossed(dungeon, dungeon.rooms.GetRect(roomIdx));
+			}
+		}
+		Check(isWhole, std::string{ "edited hallways, " } + (routeHallways ? "routed" : "straight"));
+	}
+}
+
+//Above the point count where the generator switches to the divide and conquer, the number of threads must not change the dungeon
+void TestTriangulationThreads()
+{
+	DungeonGenerator generator{};
+	for (const unsigned int seed : { 1u, 2u })
+	{
+		DungeonParams params{};
+		params.minimumNumOfRooms = 5000;
+		params.seed = seed;
+		params.ScaleSpawnArea();
+
+		generator.Reset(params);
+		const DungeonResult singleThreaded{ generator.Generate() };
+
+		params.triangulationThreads = 4;
+		generator.Reset(params);
+		Check(IsSameDungeon(singleThreaded, generator.Generate()), "5000 rooms with 4 triangulation threads, seed " + std::to_string(seed));
+	}
+}
+
+int main()
+{
+	TestInCircleKernel();
+	TestParallelTriangulation();
+	TestTriangulationThreads();
+	TestEditedTriangulation();
+	TestEditedNumOfRooms();
+	TestEditedSpanningTree();
+	TestEditedHallways();
+
+	std::cout << g_NumOfFailures << " check(s) failed" << std::endl;
+	return g_NumOfFailures > 0 ? 1 : 0;
+}
@@ -0,0 +1,199 @@
+#include "pch.h"
+#include "TextRenderer.h"
+
+#include <algorithm>
+#include <iostream>
+
+TextRenderer::~TextRenderer()
+{
+	for (const auto& pair : m_Atlases)
+	{
+		if (pair.second.textureId != 0)
+			glDeleteTextures(1, &pair.second.textureId);
+	}
+}
+
+Point2f TextRenderer::MeasureText(const std::string& text, const std::string& fontPath, int ptSize)
+{
+	const FontAtlas& atlas{ GetAtlas(fontPath, ptSize) };
+	if (!atlas.isOk) return Point2f{};
+
+	//The last glyph can stick out past its advance
+	float x{}, width{};
+	for (const char character : text)
+	{
+		const Glyph& glyph{ GetGlyph(atlas, character) };
+		width = std::max(width, x + glyph.width);
+		x += glyph.advance;
+	}
+	return Point2f{ std::max(width, x), atlas.lineHeight };
+}
+
+void TextRenderer::QueueText(const std::string& text, const std::string& fontPath, int ptSize, const Point2f& bottomLeft, const Color4f& color)
+{
+	FontAtlas& atlas{ GetAtlas(fontPath, ptSize) };
+	if (!atlas.isOk) return;
+
+	float x{ bottomLeft.x };
+	for (const char character : text)
+	{
+		const Glyph& glyph{ GetGlyph(atlas, character) };
+		if (glyph.width > 0.f)
+		{
+			const float left{ x }, right{ x + glyph.width };
+			const float bottom{ bottomLeft.y }, top{ bottomLeft.y + glyph.height };
+
+			//Same winding and texture orientation as Texture::Draw
+			atlas.vertices.insert(atlas.vertices.end(), { left, bottom, left, top, right, top, right, bottom });
+			atlas.texCoords.insert(atlas.texCoords.end(), { glyph.texLeft, glyph.texBottom, glyph.texLeft, glyph.texTop,
+				glyph.texRight, glyph.texTop, glyph.texRight, glyph.texBottom });
+			for (int i{}; i < 4; ++i)
+				atlas.colors.insert(atlas.colors.end(), { color.r, color.g, color.b, color.a });
+		}
+		x += glyph.advance;
+	}
+}
+
+void TextRenderer::Flush()
+{
+	//Text goes on top of the shapes that were batched before it
+	utils::FlushDrawBatch();
+
+	glEnable(GL_TEXTURE_2D);
+	//The glyphs are white, modulating tints them with the color of the text
+	glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+
+	for (auto& pair : m_Atlases)
+	{
+		FontAtlas& atlas{ pair.second };
+		if (atlas.vertices.empty()) continue;
+
+		glBindTexture(GL_TEXTURE_2D, atlas.textureId);
+		glVertexPointer(2, GL_FLOAT, 0, atlas.vertices.data());
+		glTexCoordPointer(2, GL_FLOAT, 0, atlas.texCoords.data());
+		glColorPointer(4, GL_FLOAT, 0, atlas.colors.data());
+		glDrawArrays(GL_QUADS, 0, GLsizei(atlas.vertices.size() / 2));
+
+		//Keeps the memory for the next frame
+		atlas.vertices.clear();
+		atlas.texCoords.clear();
+		atlas.colors.clear();
+	}
+
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glDisable(GL_TEXTURE_2D);
+}
+
+TextRenderer::FontAtlas& TextRenderer::GetAtlas(const std::string& fontPath, int ptSize)
+{
+	const auto key{ std::make_pair(fontPath, ptSize) };
+	auto it{ m_Atlases.find(key) };
+	if (it != m_Atlases.end()) return it->second;
+
+	//A font that fails to load is still added, so it is only tried once
+	FontAtlas& atlas{ m_Atlases[key] };
+	CreateAtlas(atlas, fontPath, ptSize);
+	return atlas;
+}
+
+void TextRenderer::CreateAtlas(FontAtlas& atlas, const std::string& fontPath, int ptSize)
+{
+	TTF_Font* pFont{ TTF_OpenFont(fontPath.c_str(), ptSize) };
+	if (pFont == nullptr)
+	{
+		std::cerr << "TextRenderer::CreateAtlas, error when calling TTF_OpenFont: " << TTF_GetError() << std::endl;
+		return;
+	}
+	atlas.lineHeight = float(TTF_FontHeight(pFont));
+
+	//Render every glyph on its own and pack them in rows, with a pixel between them so they do not bleed into each other
+	SDL_Surface* glyphSurfaces[m_NumOfGlyphs]{};
+	int glyphLefts[m_NumOfGlyphs]{}, glyphTops[m_NumOfGlyphs]{};
+	int x{}, y{}, rowHeight{};
+	for (int i{}; i < m_NumOfGlyphs; ++i)
+	{
+		const char text[2]{ char(m_FirstGlyph + i), '\0' };
+		int advance{};
+		if (TTF_GlyphMetrics(pFont, Uint16(text[0]), nullptr, nullptr, nullptr, nullptr, &advance) != 0) advance = 0;
+		atlas.glyphs[i].advance = float(advance);
+
+		glyphSurfaces[i] = TTF_RenderText_Blended(pFont, text, SDL_Color{ 255, 255, 255, 255 });
+		if (glyphSurfaces[i] == nullptr) continue;
+
+		const int width{ glyphSurfaces[i]->w }, height{ glyphSurfaces[i]->h };
+		if (x + width > m_AtlasWidth)
+		{
+			x = 0;
+			y += rowHeight + 1;
+			rowHeight = 0;
+		}
+		glyphLefts[i] = x;
+		glyphTops[i] = y;
+		x += width + 1;
+		rowHeight = std::max(rowHeight, height);
+	}
+
+	int atlasHeight{ 1 };
+	while (atlasHeight < y + rowHeight)
+		atlasHeight *= 2;
+
+	SDL_Surface* pAtlasSurface{ SDL_CreateRGBSurfaceWithFormat(0, m_AtlasWidth, atlasHeight, 32, SDL_PIXELFORMAT_RGBA32) };
+	if (pAtlasSurface == nullptr)
+	{
+		std::cerr << "TextRenderer::CreateAtlas, error when calling SDL_CreateRGBSurfaceWithFormat: " << SDL_GetError() << std::endl;
+	}
+	else
+	{
+		SDL_FillRect(pAtlasSurface, nullptr, 0);
+		atlas.width = float(m_AtlasWidth);
+		atlas.height = float(atlasHeight);
+	}
+
+	for (int i{}; i < m_NumOfGlyphs; ++i)
+	{
+		SDL_Surface* pGlyphSurface{ glyphSurfaces[i] };
+		if (pGlyphSurface == nullptr) continue;
+
+		if (pAtlasSurface != nullptr)
+		{
+			//Copy the alpha as is instead of blending it onto the empty atlas
+			SDL_SetSurfaceBlendMode(pGlyphSurface, SDL_BLENDMODE_NONE);
+			SDL_Rect dstRect{ glyphLefts[i], glyphTops[i], pGlyphSurface->w, pGlyphSurface->h };
+			SDL_BlitSurface(pGlyphSurface, nullptr, pAtlasSurface, &dstRect);
+
+			Glyph& glyph{ atlas.glyphs[i] };
+			glyph.width = float(pGlyphSurface->w);
+			glyph.height = float(pGlyphSurface->h);
+			glyph.texLeft = float(glyphLefts[i]) / atlas.width;
+			glyph.texRight = float(glyphLefts[i] + pGlyphSurface->w) / atlas.width;
+			glyph.texTop = float(glyphTops[i]) / atlas.height;
+			glyph.texBottom = float(glyphTops[i] + pGlyphSurface->h) / atlas.height;
+		}
+		SDL_FreeSurface(pGlyphSurface);
+	}
+	TTF_CloseFont(pFont);
+
+	if (pAtlasSurface == nullptr) return;
+
+	glGenTextures(1, &atlas.textureId);
+	glBindTexture(GL_TEXTURE_2D, atlas.textureId);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, pAtlasSurface->w, pAtlasSurface->h, 0, GL_RGBA, GL_UNSIGNED_BYTE, pAtlasSurface->pixels);
+	//The font is a pixel font, keep it sharp like the textures
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	SDL_FreeSurface(pAtlasSurface);
+
+	atlas.isOk = true;
+}
+
+const TextRenderer::Glyph& TextRenderer::GetGlyph(const FontAtlas& atlas, char character) const
+{
+	if (character < m_FirstGlyph || character > m_LastGlyph) character = ' ';
+	return atlas.glyphs[character - m_FirstGlyph];
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+
+//Draws text from one glyph atlas texture per font and size instead of making a Texture for every string.
+//Fonts are opened and rasterized once, the first time they are used. Text is queued as quads and drawn
+//with one call per atlas when Flush is called, so flush before the transform the text was queued with changes.
+class TextRenderer final
+{
+public:
+	TextRenderer() = default;
+	TextRenderer(const TextRenderer& other) = delete;
+	TextRenderer& operator=(const TextRenderer& other) = delete;
+	TextRenderer(TextRenderer&& other) = delete;
+	TextRenderer& operator=(TextRenderer&& other) = delete;
+	~TextRenderer();
+
+	//Size the text would have when drawn, the same size a Texture made from the text would have
+	Point2f MeasureText(const std::string& text, const std::string& fontPath, int ptSize);
+	//Queues the text with its bottom left at the position
+	void QueueText(const std::string& text, const std::string& fontPath, int ptSize, const Point2f& bottomLeft, const Color4f& color);
+	//Draws everything that was queued since the last flush
+	void Flush();
+
+private:
+	//Only the printable ascii characters get a glyph, everything else is drawn as a space
+	static constexpr char m_FirstGlyph{ ' ' };
+	static constexpr char m_LastGlyph{ '~' };
+	static constexpr int m_NumOfGlyphs{ m_LastGlyph - m_FirstGlyph + 1 };
+	static constexpr int m_AtlasWidth{ 512 };
+
+	struct Glyph
+	{
+		//Texture coordinates, the top of the atlas is 0 like the surface it came from
+		float texLeft, texRight, texTop, texBottom;
+		float width, height; //In pixels
+		float advance; //Distance to the next glyph
+	};
+
+	struct FontAtlas
+	{
+		GLuint textureId{};
+		float width{}, height{}; //Of the atlas texture
+		float lineHeight{};
+		Glyph glyphs[m_NumOfGlyphs]{};
+		bool isOk{ false };
+
+		//Queued quads, 4 vertices each
+		std::vector<float> vertices{};
+		std::vector<float> texCoords{};
+		std::vector<float> colors{};
+	};
+
+	std::map<std::pair<std::string, int>, FontAtlas> m_Atlases{};
+
+	FontAtlas& GetAtlas(const std::string& fontPath, int ptSize);
+	void CreateAtlas(FontAtlas& atlas, const std::string& fontPath, int ptSize);
+	const Glyph& GetGlyph(const FontAtlas& atlas, char character) const;
+};
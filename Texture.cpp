@@ -240,6 +240,9 @@ void Texture::Draw( const Point2f& dstBottomLeft, const Rectf& srcRect ) const
 
 void Texture::Draw( const Rectf& dstRect, const Rectf& srcRect ) const
 {
+	// Everything that was batched before has to be below the texture
+	utils::FlushDrawBatch( );
+
 	const float epsilon{ 0.001f };
 	if ( !m_CreationOk )
 	{
@@ -0,0 +1,92 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+//Fixed amount of worker threads that run queued tasks
+class ThreadPool final
+{
+public:
+	//0 threads means one per hardware thread
+	explicit ThreadPool(int numOfThreads = 0)
+	{
+		if (numOfThreads <= 0) numOfThreads = int(std::thread::hardware_concurrency());
+		if (numOfThreads <= 0) numOfThreads = 1;
+
+		m_Threads.reserve(numOfThreads);
+		for (int i{}; i < numOfThreads; ++i)
+			m_Threads.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+	ThreadPool(const ThreadPool& other) = delete;
+	ThreadPool& operator=(const ThreadPool& other) = delete;
+	ThreadPool(ThreadPool&& other) = delete;
+	ThreadPool& operator=(ThreadPool&& other) = delete;
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock{ m_Mutex };
+			m_IsStopping = true;
+		}
+		m_TaskAdded.notify_all();
+
+		for (auto& thread : m_Threads)
+			thread.join();
+	}
+
+	void Enqueue(std::function<void()> task)
+	{
+		{
+			std::lock_guard<std::mutex> lock{ m_Mutex };
+			m_Tasks.emplace(std::move(task));
+		}
+		m_TaskAdded.notify_one();
+	}
+
+	//Blocks until every queued task has finished
+	void Wait()
+	{
+		std::unique_lock<std::mutex> lock{ m_Mutex };
+		m_TasksFinished.wait(lock, [this] { return m_Tasks.empty() && m_NumOfRunningTasks == 0; });
+	}
+
+	int GetNumOfThreads() const { return int(m_Threads.size()); }
+
+private:
+	std::vector<std::thread> m_Threads{};
+	std::queue<std::function<void()>> m_Tasks{};
+
+	std::mutex m_Mutex{};
+	std::condition_variable m_TaskAdded{};
+	std::condition_variable m_TasksFinished{};
+	int m_NumOfRunningTasks{};
+	bool m_IsStopping{ false };
+
+	void WorkerLoop()
+	{
+		while (true)
+		{
+			std::function<void()> task{};
+			{
+				std::unique_lock<std::mutex> lock{ m_Mutex };
+				m_TaskAdded.wait(lock, [this] { return m_IsStopping || !m_Tasks.empty(); });
+				if (m_Tasks.empty()) return; //Only happens when stopping
+
+				task = std::move(m_Tasks.front());
+				m_Tasks.pop();
+				++m_NumOfRunningTasks;
+			}
+
+			task();
+
+			{
+				std::lock_guard<std::mutex> lock{ m_Mutex };
+				--m_NumOfRunningTasks;
+			}
+			m_TasksFinished.notify_all();
+		}
+	}
+};
@@ -9,6 +9,10 @@ namespace utils
 #pragma region OpenGLDrawFunctionality
 
 	void SetColor( const Color4f& color );
+	// The draw functions below are batched. Batches are drawn in the order their mode and line width
+	// were first used, so call this before changing the transform, drawing textures, or when a layer
+	// has to end up on top of everything drawn before it.
+	void FlushDrawBatch( );
 	
 	void DrawPoint( float x, float y, float pointSize = 1.0f );
 	void DrawPoint( const Point2f& p, float pointSize = 1.0f );